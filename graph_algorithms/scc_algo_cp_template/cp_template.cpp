@@ -1,8 +1,11 @@
 #include <iostream>
 #include <vector>
-#include <stack>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <sys/resource.h>
 
 using namespace std;
 
@@ -16,175 +19,478 @@ typedef long long ll;
 typedef vector<int> vi;
 typedef pair<int, int> pii;
 
-const int N = 1e5 + 5; // Adjust size accordingly
+bool print_sccs = true; // Set to false to only record components (e.g. when benchmarking)
 
-// ---------- GLOBAL VARIABLES ----------
-vector<int> adj[N];  // Graph
-vector<int> radj[N]; // Reverse Graph (Kosaraju)
-bool visited[N];
-vector<int> sccs[N]; // Stores components in Kosaraju
-
-// ---------- TARJAN VARIABLES ----------
-int disc[N], low[N], timer;
-bool inStack[N];
-stack<int> st;
-int scc_count_tarjan;
-
-// ---------- TARJAN'S ALGORITHM ----------
-void tarjan_dfs(int u)
+// ---------- FAST INTEGER READER ----------
+// Reads whitespace separated integers from a FILE* through a 64 KiB buffer.
+struct FastReader
 {
-    disc[u] = low[u] = ++timer;
-    st.push(u);
-    inStack[u] = true;
+    FILE *in;
+    char buf[1 << 16];
+    size_t len = 0, pos = 0;
+
+    explicit FastReader(FILE *f = stdin) : in(f) {}
 
-    for (int v : adj[u])
+    int get()
     {
-        if (!disc[v])
-        {
-            tarjan_dfs(v);
-            low[u] = min(low[u], low[v]);
-        }
-        else if (inStack[v])
+        if (pos == len)
         {
-            low[u] = min(low[u], disc[v]);
+            len = fread(buf, 1, sizeof(buf), in);
+            pos = 0;
+            if (len == 0)
+                return -1;
         }
+        return buf[pos++];
     }
 
-    if (low[u] == disc[u])
+    // Returns false at end of input.
+    bool read(int &x)
     {
-        ++scc_count_tarjan;
-        cout << "Tarjan SCC #" << scc_count_tarjan << ": ";
-        while (true)
+        int c = get();
+        while (c != -1 && c != '-' && (c < '0' || c > '9'))
+            c = get();
+        if (c == -1)
+            return false;
+        bool neg = c == '-';
+        if (neg)
+            c = get();
+        x = 0;
+        while (c >= '0' && c <= '9')
         {
-            int v = st.top();
-            st.pop();
-            inStack[v] = false;
-            cout << v << " ";
-            if (v == u)
-                break;
+            x = x * 10 + (c - '0');
+            c = get();
         }
-        cout << "\n";
+        if (neg)
+            x = -x;
+        return true;
     }
-}
+};
 
-void tarjan(int n)
+// ---------- RUN STATISTICS ----------
+// Per-phase wall time, edges scanned and peak RSS, plus the deepest DFS stack. Only the
+// tarjan<true>() / kosaraju<true>() instantiations record into it; the default ones
+// compile without any counting.
+struct SCCStats
 {
-    timer = 0;
-    scc_count_tarjan = 0;
-    memset(disc, 0, sizeof(disc));
-    memset(low, 0, sizeof(low));
-    memset(inStack, 0, sizeof(inStack));
+    struct Phase
+    {
+        string name;
+        double seconds;
+        ll edges_scanned, peak_rss;
+    };
+    vector<Phase> phases;
+    chrono::steady_clock::time_point started;
+    ll edges = 0; // edges scanned in the running phase
+    int max_depth = 0;
 
-    for (int i = 1; i <= n; ++i)
+    // Same as SccInstrumentation::peakRssBytes() in scc_algo_dev_template; this file stays
+    // self-contained, so keep the two in sync.
+    static ll peak_rss()
     {
-        if (!disc[i])
-        {
-            tarjan_dfs(i);
-        }
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        return (ll)usage.ru_maxrss * 1024;
+#endif
     }
-}
 
-// ---------- KOSARAJU'S ALGORITHM ----------
-vector<int> order;
-int scc_count_kosaraju;
+    void clear()
+    {
+        phases.clear();
+        max_depth = 0;
+    }
 
-void dfs1(int u)
-{
-    visited[u] = true;
-    for (int v : adj[u])
+    void begin()
     {
-        if (!visited[v])
-            dfs1(v);
+        edges = 0;
+        started = chrono::steady_clock::now();
     }
-    order.push_back(u);
-}
 
-void dfs2(int u, int comp_id)
-{
-    visited[u] = true;
-    sccs[comp_id].push_back(u);
+    void end(const char *name)
+    {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        phases.push_back({name, seconds, edges, peak_rss()});
+    }
 
-    for (int v : radj[u])
+    void depth(int d)
     {
-        if (!visited[v])
-            dfs2(v, comp_id);
+        max_depth = max(max_depth, d);
     }
-}
+};
 
-void kosaraju(int n)
+// ---------- SCC ENGINE ----------
+// Reusable Tarjan / Kosaraju engine for 1-indexed graphs. Buffers only ever grow, and
+// init() resets just the first n + 1 entries, so a run costs O(n + m) however large the
+// previous graphs were. Both DFS are iterative, so deep graphs cannot overflow the stack;
+// they visit vertices in the same order as the recursive versions.
+struct SCCEngine
 {
-    memset(visited, 0, sizeof(visited));
-    order.clear();
+    int n = 0;
+    vi eu, ev;                   // edges in insertion order
+    vi start, to, rstart, rto;   // CSR graph and reverse graph
+    vi disc, low, comp, it, dfs; // per-vertex DFS state and explicit DFS stack
+    vi st, order;                // Tarjan stack / Kosaraju finishing order
+    vector<char> mark;           // inStack (Tarjan) / visited (Kosaraju)
+    vi sccOrder, sccStart;       // vertices grouped by SCC, in discovery order
+    int timer = 0, scc_count = 0;
+    SCCStats stats;              // filled by tarjan<true>() / kosaraju<true>() only
 
-    // 1st pass to get finishing order
-    for (int i = 1; i <= n; ++i)
+    template <typename T>
+    static void reset(vector<T> &a, size_t size, T value)
     {
-        if (!visited[i])
-            dfs1(i);
+        if (a.size() < size)
+            a.resize(size);
+        fill(a.begin(), a.begin() + size, value);
     }
 
-    memset(visited, 0, sizeof(visited));
-    scc_count_kosaraju = 0;
+    void init(int nodes)
+    {
+        n = nodes;
+        eu.clear();
+        ev.clear();
+    }
 
-    // 2nd pass on reversed graph
-    reverse(order.begin(), order.end());
-    for (int u : order)
+    void add_edge(int u, int v)
     {
-        if (!visited[u])
+        eu.push_back(u);
+        ev.push_back(v);
+    }
+
+    // Counting sort of the edges into CSR; stable, so neighbours keep their insertion order.
+    void build_csr(vi &s, vi &t, const vi &from, const vi &dest)
+    {
+        int m = from.size();
+        reset(s, n + 2, 0);
+        if ((int)t.size() < m)
+            t.resize(m);
+        for (int i = 0; i < m; ++i)
+            ++s[from[i] + 1];
+        for (int u = 0; u <= n; ++u)
+            s[u + 1] += s[u];
+        for (int i = 0; i < m; ++i)
+            t[s[from[i]]++] = dest[i];
+        for (int u = n; u > 0; --u)
+            s[u] = s[u - 1];
+        s[0] = 0;
+    }
+
+    void build()
+    {
+        build_csr(start, to, eu, ev);
+        build_csr(rstart, rto, ev, eu);
+    }
+
+    void begin_components()
+    {
+        scc_count = 0;
+        sccOrder.clear();
+        sccStart.assign(1, 0);
+        reset(comp, n + 1, 0);
+        reset(it, n + 1, 0);
+    }
+
+    void close_component()
+    {
+        ++scc_count;
+        sccStart.push_back(sccOrder.size());
+    }
+
+    // ---------- TARJAN'S ALGORITHM ----------
+    // Track = true also records phase "tarjan" into stats.
+    template <bool Track = false>
+    int tarjan()
+    {
+        if constexpr (Track)
+            stats.begin();
+        timer = 0;
+        begin_components();
+        reset(disc, n + 1, 0);
+        reset(low, n + 1, 0);
+        reset(mark, n + 1, (char)0);
+        st.clear();
+
+        for (int i = 1; i <= n; ++i)
         {
-            ++scc_count_kosaraju;
-            dfs2(u, scc_count_kosaraju);
+            if (disc[i])
+                continue;
+            dfs.assign(1, i);
+            disc[i] = low[i] = ++timer;
+            st.push_back(i);
+            mark[i] = 1;
+            it[i] = start[i];
+
+            while (!dfs.empty())
+            {
+                int u = dfs.back();
+                if (it[u] < start[u + 1])
+                {
+                    int v = to[it[u]++];
+                    if constexpr (Track)
+                        ++stats.edges;
+                    if (!disc[v])
+                    {
+                        disc[v] = low[v] = ++timer;
+                        st.push_back(v);
+                        mark[v] = 1;
+                        it[v] = start[v];
+                        dfs.push_back(v);
+                        if constexpr (Track)
+                            stats.depth(dfs.size());
+                    }
+                    else if (mark[v])
+                    {
+                        low[u] = min(low[u], disc[v]);
+                    }
+                    continue;
+                }
+
+                dfs.pop_back();
+                if (!dfs.empty())
+                    low[dfs.back()] = min(low[dfs.back()], low[u]);
+
+                if (low[u] == disc[u])
+                {
+                    while (true)
+                    {
+                        int v = st.back();
+                        st.pop_back();
+                        mark[v] = 0;
+                        comp[v] = scc_count + 1;
+                        sccOrder.push_back(v);
+                        if (v == u)
+                            break;
+                    }
+                    close_component();
+                }
+            }
         }
+        if constexpr (Track)
+            stats.end("tarjan");
+        return scc_count;
     }
 
-    // Print SCCs
-    for (int i = 1; i <= scc_count_kosaraju; ++i)
+    // ---------- KOSARAJU'S ALGORITHM ----------
+    // Track = true also records phases "first_dfs" and "reverse_dfs" into stats.
+    template <bool Track = false>
+    int kosaraju()
     {
-        cout << "Kosaraju SCC #" << i << ": ";
-        for (int v : sccs[i])
+        if constexpr (Track)
+            stats.begin();
+        begin_components();
+        reset(mark, n + 1, (char)0);
+        order.clear();
+
+        // 1st pass to get finishing order
+        for (int i = 1; i <= n; ++i)
+        {
+            if (mark[i])
+                continue;
+            dfs.assign(1, i);
+            mark[i] = 1;
+            it[i] = start[i];
+            while (!dfs.empty())
+            {
+                int u = dfs.back();
+                if (it[u] < start[u + 1])
+                {
+                    int v = to[it[u]++];
+                    if constexpr (Track)
+                        ++stats.edges;
+                    if (!mark[v])
+                    {
+                        mark[v] = 1;
+                        it[v] = start[v];
+                        dfs.push_back(v);
+                        if constexpr (Track)
+                            stats.depth(dfs.size());
+                    }
+                    continue;
+                }
+                dfs.pop_back();
+                order.push_back(u);
+            }
+        }
+
+        if constexpr (Track)
+        {
+            stats.end("first_dfs");
+            stats.begin();
+        }
+        reset(mark, n + 1, (char)0);
+
+        // 2nd pass on reversed graph, in decreasing finishing time
+        for (int k = (int)order.size() - 1; k >= 0; --k)
         {
-            cout << v << " ";
+            int s = order[k];
+            if (mark[s])
+                continue;
+            dfs.assign(1, s);
+            mark[s] = 1;
+            comp[s] = scc_count + 1;
+            sccOrder.push_back(s);
+            it[s] = rstart[s];
+            while (!dfs.empty())
+            {
+                int u = dfs.back();
+                if (it[u] < rstart[u + 1])
+                {
+                    int v = rto[it[u]++];
+                    if constexpr (Track)
+                        ++stats.edges;
+                    if (!mark[v])
+                    {
+                        mark[v] = 1;
+                        comp[v] = scc_count + 1;
+                        sccOrder.push_back(v);
+                        it[v] = rstart[v];
+                        dfs.push_back(v);
+                        if constexpr (Track)
+                            stats.depth(dfs.size());
+                    }
+                    continue;
+                }
+                dfs.pop_back();
+            }
+            close_component();
         }
-        cout << "\n";
+        if constexpr (Track)
+            stats.end("reverse_dfs");
+        return scc_count;
     }
-}
 
-// ---------- CLEAR GRAPH ----------
-void clear_graph(int n)
-{
-    for (int i = 0; i <= n; ++i)
+    void print(const char *name) const
     {
-        adj[i].clear();
-        radj[i].clear();
-        sccs[i].clear();
+        if (!print_sccs)
+            return;
+        for (int c = 0; c < scc_count; ++c)
+        {
+            cout << name << " SCC #" << c + 1 << ": ";
+            for (int k = sccStart[c]; k < sccStart[c + 1]; ++k)
+            {
+                cout << sccOrder[k] << " ";
+            }
+            cout << "\n";
+        }
     }
-    while (!st.empty())
-        st.pop();
-}
+
+    // One JSON line with stats and the component sizes of the last run. The layout is
+    // defined by SccInstrumentation::writeJson() in scc_algo_dev_template/scc_instrumentation.cpp;
+    // this is a hand-written copy so the template needs no other file, so change both together.
+    void print_stats(FILE *out, const char *engine_name) const
+    {
+        ll buckets[64] = {}, largest = 0, total_rss = SCCStats::peak_rss();
+        double total = 0;
+        for (int c = 0; c < scc_count; ++c)
+        {
+            ll size = sccStart[c + 1] - sccStart[c];
+            largest = max(largest, size);
+            ++buckets[63 - __builtin_clzll(size)];
+        }
+        fprintf(out, "{\"engine\":\"%s\",\"vertices\":%d,\"edges\":%zu", engine_name, n, eu.size());
+        for (const auto &p : stats.phases)
+            total += p.seconds;
+        fprintf(out, ",\"total_seconds\":%g,\"max_dfs_depth\":%d,\"peak_rss_bytes\":%lld,\"phases\":[",
+                total, stats.max_depth, total_rss);
+        for (size_t i = 0; i < stats.phases.size(); ++i)
+        {
+            const auto &p = stats.phases[i];
+            fprintf(out, "%s{\"name\":\"%s\",\"seconds\":%g,\"edges_scanned\":%lld,\"peak_rss_bytes\":%lld}",
+                    i ? "," : "", p.name.c_str(), p.seconds, p.edges_scanned, p.peak_rss);
+        }
+        fprintf(out, "],\"components\":{\"count\":%d,\"largest\":%lld,\"histogram\":[", scc_count, largest);
+        bool first = true;
+        for (int k = 0; k < 64; ++k)
+        {
+            if (!buckets[k])
+                continue;
+            fprintf(out, "%s{\"min_size\":%llu,\"max_size\":%llu,\"count\":%lld}", first ? "" : ",",
+                    1ULL << k, (2ULL << k) - 1, buckets[k]);
+            first = false;
+        }
+        fprintf(out, "]},\"counters\":{}}\n");
+    }
+};
 
 // ---------- DRIVER ----------
-int main()
+// Define CP_TEMPLATE_NO_DRIVER to reuse the engine above from another program.
+// Run with --stats to get one JSON line per engine and graph on stderr; the "read" and
+// "build_csr" phases of a graph are shared, so both of its lines repeat them.
+#ifndef CP_TEMPLATE_NO_DRIVER
+template <bool Track>
+void solve_all(FastReader &in, SCCEngine &engine)
 {
-    fastio;
+    SCCStats shared;
 
+    // Processes every "n m" graph in the input, one after another
     int n, m;
-    cin >> n >> m; // Number of nodes and edges
+    while (in.read(n) && in.read(m) && n >= 0) // Number of nodes and edges
+    {
+        if constexpr (Track)
+        {
+            shared.clear();
+            shared.begin();
+        }
+        engine.init(n);
+        for (int i = 0; i < m; ++i)
+        {
+            int u, v;
+            if (!in.read(u) || !in.read(v))
+                break; // truncated input: solve the edges read so far
+            if (u < 1 || u > n || v < 1 || v > n)
+                continue; // vertex out of range: the CSR buffers are sized for 1..n only
+            engine.add_edge(u, v);
+        }
+        if constexpr (Track)
+        {
+            shared.end("read");
+            shared.begin();
+        }
+        engine.build();
+        if constexpr (Track)
+            shared.end("build_csr");
 
-    clear_graph(n);
+        cout << "====== Tarjan's Algorithm ======\n";
+        engine.stats = shared;
+        engine.tarjan<Track>();
+        if constexpr (Track)
+            engine.stats.begin();
+        engine.print("Tarjan");
+        if constexpr (Track)
+        {
+            engine.stats.end("output");
+            cout.flush();
+            engine.print_stats(stderr, "cp-tarjan");
+        }
 
-    for (int i = 0; i < m; ++i)
-    {
-        int u, v;
-        cin >> u >> v;
-        adj[u].push_back(v);
-        radj[v].push_back(u);
+        cout << "\n====== Kosaraju's Algorithm ======\n";
+        engine.stats = shared;
+        engine.kosaraju<Track>();
+        if constexpr (Track)
+            engine.stats.begin();
+        engine.print("Kosaraju");
+        if constexpr (Track)
+        {
+            engine.stats.end("output");
+            cout.flush();
+            engine.print_stats(stderr, "cp-kosaraju");
+        }
     }
+}
+
+int main(int argc, char **argv)
+{
+    fastio;
 
-    cout << "====== Tarjan's Algorithm ======\n";
-    tarjan(n);
+    FastReader in;
+    SCCEngine engine;
 
-    cout << "\n====== Kosaraju's Algorithm ======\n";
-    kosaraju(n);
+    if (argc > 1 && strcmp(argv[1], "--stats") == 0)
+        solve_all<true>(in, engine);
+    else
+        solve_all<false>(in, engine);
 
     return 0;
 }
+#endif // CP_TEMPLATE_NO_DRIVER
@@ -53,6 +53,18 @@ void Graph::addEdge(const string &uName, const string &vName)
     revAdj[v].push_back(u);
 }
 
+/**
+ * @brief Adds a directed edge between two nodes identified by their IDs.
+ *
+ * @param u The ID of the source node.
+ * @param v The ID of the destination node.
+ */
+void Graph::addEdgeById(int u, int v)
+{
+    adj[u].push_back(v);
+    revAdj[v].push_back(u);
+}
+
 /**
  * @brief Returns the number of vertices currently in the graph.
  *
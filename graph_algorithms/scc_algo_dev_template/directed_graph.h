@@ -59,6 +59,16 @@ public:
      */
     void addEdge(const string &u, const string &v);
 
+    /**
+     * @brief Adds a directed edge between two nodes that already have IDs.
+     *
+     * Skips the name lookup of addEdge(); both IDs must come from getId().
+     *
+     * @param u The ID of the source node.
+     * @param v The ID of the destination node.
+     */
+    void addEdgeById(int u, int v);
+
     /**
      * @brief Returns the number of vertices in the graph.
      *
@@ -0,0 +1,328 @@
+#include "edge_file.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    const char EDGE_FILE_MAGIC[8] = {'S', 'C', 'C', 'E', 'D', 'G', 'E', '1'};
+
+    /**
+     * @brief Returns true if edge a sorts before edge b in the given order.
+     */
+    bool edgeLess(const Edge &a, const Edge &b, EdgeOrder order)
+    {
+        if (order == EdgeOrder::ByDestination)
+        {
+            return a.dst != b.dst ? a.dst < b.dst : a.src < b.src;
+        }
+        return a.src != b.src ? a.src < b.src : a.dst < b.dst;
+    }
+
+    /**
+     * @brief Temporary files removed when the owner goes out of scope, including when a sort
+     *        throws halfway through.
+     */
+    struct TemporaryFiles
+    {
+        vector<string> paths;
+
+        ~TemporaryFiles()
+        {
+            for (const string &path : paths)
+            {
+                remove(path.c_str());
+            }
+        }
+    };
+}
+
+/**
+ * @brief Creates the output file and reserves space for the header.
+ *
+ * @param path Output file.
+ * @param bufferBytes Size of the output buffer.
+ */
+EdgeFileWriter::EdgeFileWriter(const string &path, size_t bufferBytes)
+    : buffer(max<size_t>(1, bufferBytes / sizeof(Edge))), used(0), count(0)
+{
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        throw runtime_error("cannot create edge file " + path);
+    }
+    EdgeFileHeader placeholder = {};
+    if (fwrite(&placeholder, sizeof(placeholder), 1, file) != 1)
+    {
+        fclose(file);
+        throw runtime_error("cannot write header of edge file " + path);
+    }
+}
+
+EdgeFileWriter::~EdgeFileWriter()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Writes the buffered edges to the file.
+ */
+void EdgeFileWriter::flush()
+{
+    if (used > 0 && fwrite(buffer.data(), sizeof(Edge), used, file) != used)
+    {
+        throw runtime_error("short write to edge file");
+    }
+    used = 0;
+}
+
+/**
+ * @brief Appends an edge to the output buffer.
+ *
+ * @param e The edge to write.
+ */
+void EdgeFileWriter::write(const Edge &e)
+{
+    if (used == buffer.size())
+    {
+        flush();
+    }
+    buffer[used++] = e;
+    ++count;
+}
+
+/**
+ * @brief Completes the file by writing its header.
+ *
+ * @param vertices Number of nodes.
+ * @param order Order in which the edges were written.
+ */
+void EdgeFileWriter::close(uint64_t vertices, EdgeOrder order)
+{
+    flush();
+    EdgeFileHeader header = {};
+    memcpy(header.magic, EDGE_FILE_MAGIC, sizeof(header.magic));
+    header.vertices = vertices;
+    header.edges = count;
+    header.order = static_cast<uint32_t>(order);
+    if (fseeko(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        throw runtime_error("cannot write edge file header");
+    }
+    // fclose() flushes the last buffered bytes, so its failure means a truncated file too.
+    FILE *done = file;
+    file = nullptr;
+    if (fclose(done) != 0)
+    {
+        throw runtime_error("cannot close edge file");
+    }
+}
+
+/**
+ * @brief Opens an edge file and validates its header.
+ *
+ * @param path Input file.
+ * @param bufferBytes Size of the read buffer.
+ */
+EdgeFileReader::EdgeFileReader(const string &path, size_t bufferBytes)
+    : buffer(max<size_t>(1, bufferBytes / sizeof(Edge))), edgesRead(0)
+{
+    file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        throw runtime_error("cannot open edge file " + path);
+    }
+    if (fread(&fileHeader, sizeof(fileHeader), 1, file) != 1 ||
+        memcmp(fileHeader.magic, EDGE_FILE_MAGIC, sizeof(fileHeader.magic)) != 0)
+    {
+        fclose(file);
+        throw runtime_error(path + " is not an edge file");
+    }
+    rewind(false);
+}
+
+EdgeFileReader::~EdgeFileReader()
+{
+    fclose(file);
+}
+
+/**
+ * @brief Returns the header of the file.
+ */
+const EdgeFileHeader &EdgeFileReader::header() const
+{
+    return fileHeader;
+}
+
+/**
+ * @brief Restarts the scan in the requested direction.
+ *
+ * @param reverse Scan from the last edge towards the first.
+ */
+void EdgeFileReader::rewind(bool reverse)
+{
+    backward = reverse;
+    bufferSize = 0;
+    position = 0;
+    uint64_t blocks = (fileHeader.edges + buffer.size() - 1) / buffer.size();
+    nextBlock = backward ? blocks : 0;
+}
+
+/**
+ * @brief Loads the next buffer of the scan.
+ *
+ * @return bool False if the scan is complete.
+ */
+bool EdgeFileReader::refill()
+{
+    uint64_t blocks = (fileHeader.edges + buffer.size() - 1) / buffer.size();
+    uint64_t block;
+    if (backward)
+    {
+        if (nextBlock == 0)
+            return false;
+        block = --nextBlock;
+    }
+    else
+    {
+        if (nextBlock == blocks)
+            return false;
+        block = nextBlock++;
+    }
+
+    uint64_t first = block * buffer.size();
+    bufferSize = min<uint64_t>(buffer.size(), fileHeader.edges - first);
+    if (fseeko(file, sizeof(EdgeFileHeader) + first * sizeof(Edge), SEEK_SET) != 0)
+    {
+        throw runtime_error("cannot seek in edge file");
+    }
+    if (fread(buffer.data(), sizeof(Edge), bufferSize, file) != bufferSize)
+    {
+        throw runtime_error("short read from edge file");
+    }
+    position = 0;
+    return true;
+}
+
+/**
+ * @brief Reads the next edge of the current scan.
+ *
+ * @param e Output receiving the edge.
+ * @return bool False once the scan is complete.
+ */
+bool EdgeFileReader::next(Edge &e)
+{
+    if (position == bufferSize && !refill())
+    {
+        return false;
+    }
+    e = backward ? buffer[bufferSize - 1 - position] : buffer[position];
+    ++position;
+    ++edgesRead;
+    return true;
+}
+
+/**
+ * @brief Returns the number of edges read since the reader was opened.
+ */
+uint64_t EdgeFileReader::totalEdgesRead() const
+{
+    return edgesRead;
+}
+
+/**
+ * @brief External merge sort of an edge file.
+ *
+ * @param input Unsorted edge file.
+ * @param output Sorted edge file to create.
+ * @param order BySource or ByDestination.
+ * @param memoryBytes Memory budget for the in-memory runs.
+ */
+void EdgeFileSorter::sort(const string &input, const string &output, EdgeOrder order, size_t memoryBytes)
+{
+    auto less = [order](const Edge &a, const Edge &b)
+    { return edgeLess(a, b, order); };
+
+    EdgeFileReader reader(input, 1 << 20);
+    uint64_t vertices = reader.header().vertices;
+
+    // Phase 1: sorted runs of memoryBytes each. The run files are removed on every exit,
+    // and destroyed after the readers below, which are declared later.
+    TemporaryFiles temporaries;
+    vector<string> &runs = temporaries.paths;
+    {
+        vector<Edge> run;
+        run.reserve(max<size_t>(1, memoryBytes / sizeof(Edge)));
+        Edge e;
+        bool more = true;
+        while (more)
+        {
+            run.clear();
+            while (run.size() < run.capacity() && (more = reader.next(e)))
+            {
+                run.push_back(e);
+            }
+            if (run.empty() && !runs.empty())
+            {
+                break;
+            }
+            std::sort(run.begin(), run.end(), less);
+            runs.push_back(output + ".run" + to_string(runs.size()));
+            EdgeFileWriter writer(runs.back(), 1 << 20);
+            for (const Edge &r : run)
+            {
+                writer.write(r);
+            }
+            writer.close(vertices, order);
+        }
+    }
+
+    if (runs.size() == 1)
+    {
+        if (rename(runs[0].c_str(), output.c_str()) != 0)
+        {
+            throw runtime_error("cannot create " + output);
+        }
+        return;
+    }
+
+    // Phase 2: k-way merge, splitting the memory budget between the run readers.
+    size_t perRun = max<size_t>(1 << 16, memoryBytes / (runs.size() + 1));
+    vector<unique_ptr<EdgeFileReader>> readers;
+    for (const string &path : runs)
+    {
+        readers.emplace_back(new EdgeFileReader(path, perRun));
+    }
+
+    typedef pair<Edge, size_t> HeapEntry;
+    auto heapGreater = [&](const HeapEntry &a, const HeapEntry &b)
+    { return less(b.first, a.first); };
+    priority_queue<HeapEntry, vector<HeapEntry>, decltype(heapGreater)> heap(heapGreater);
+
+    Edge e;
+    for (size_t i = 0; i < readers.size(); ++i)
+    {
+        if (readers[i]->next(e))
+        {
+            heap.push({e, i});
+        }
+    }
+
+    EdgeFileWriter writer(output, perRun);
+    while (!heap.empty())
+    {
+        HeapEntry top = heap.top();
+        heap.pop();
+        writer.write(top.first);
+        if (readers[top.second]->next(e))
+        {
+            heap.push({e, top.second});
+        }
+    }
+    writer.close(vertices, order);
+}
@@ -0,0 +1,157 @@
+#ifndef EDGE_FILE_H
+#define EDGE_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief A directed edge between two dense node IDs, as stored on disk.
+ */
+struct Edge
+{
+    uint32_t src;
+    uint32_t dst;
+};
+
+/**
+ * @brief Order of the edges inside an edge file.
+ */
+enum class EdgeOrder : uint32_t
+{
+    Unsorted = 0,
+    BySource = 1,
+    ByDestination = 2
+};
+
+/**
+ * @brief Fixed-size header at the start of every binary edge file.
+ *
+ * The header is followed by `edges` packed Edge records.
+ */
+struct EdgeFileHeader
+{
+    char magic[8];
+    uint64_t vertices;
+    uint64_t edges;
+    uint32_t order;
+    uint32_t reserved;
+};
+
+/**
+ * @brief Writes a binary edge file through a large output buffer.
+ */
+class EdgeFileWriter
+{
+private:
+    FILE *file;
+    vector<Edge> buffer;
+    size_t used;
+    uint64_t count;
+
+    void flush();
+
+public:
+    /**
+     * @brief Creates (or truncates) the file at path.
+     *
+     * @param path Output file.
+     * @param bufferBytes Size of the output buffer.
+     */
+    EdgeFileWriter(const string &path, size_t bufferBytes);
+
+    ~EdgeFileWriter();
+
+    /**
+     * @brief Appends an edge to the file.
+     */
+    void write(const Edge &e);
+
+    /**
+     * @brief Flushes the buffer, writes the final header and closes the file.
+     *
+     * @param vertices Number of nodes; every edge endpoint must be below it.
+     * @param order Order in which the edges were written.
+     */
+    void close(uint64_t vertices, EdgeOrder order);
+};
+
+/**
+ * @brief Streams the edges of a binary edge file with large sequential reads.
+ *
+ * The file can be scanned front to back or back to front; the backward scan still reads
+ * whole buffers sequentially and only walks each buffer in reverse.
+ */
+class EdgeFileReader
+{
+private:
+    FILE *file;
+    EdgeFileHeader fileHeader;
+    vector<Edge> buffer;
+    size_t bufferSize;
+    size_t position;
+    uint64_t nextBlock;
+    bool backward;
+    uint64_t edgesRead;
+
+    bool refill();
+
+public:
+    /**
+     * @brief Opens the file at path and validates its header.
+     *
+     * @param path Input file.
+     * @param bufferBytes Size of the read buffer.
+     */
+    EdgeFileReader(const string &path, size_t bufferBytes);
+
+    ~EdgeFileReader();
+
+    /**
+     * @brief Returns the header of the file.
+     */
+    const EdgeFileHeader &header() const;
+
+    /**
+     * @brief Restarts the scan from the first (or, if reverse is set, the last) edge.
+     */
+    void rewind(bool reverse = false);
+
+    /**
+     * @brief Reads the next edge of the current scan.
+     *
+     * @param e Output receiving the edge.
+     * @return bool False once the scan has reached the end of the file.
+     */
+    bool next(Edge &e);
+
+    /**
+     * @brief Returns the number of edges read since the reader was opened.
+     */
+    uint64_t totalEdgesRead() const;
+};
+
+/**
+ * @brief Sorts binary edge files larger than memory with an external merge sort.
+ */
+class EdgeFileSorter
+{
+public:
+    /**
+     * @brief Sorts the edges of input into output.
+     *
+     * Runs of memoryBytes are sorted in memory and written to temporary files next to
+     * output, which are then merged in a single k-way pass.
+     *
+     * @param input Unsorted edge file.
+     * @param output Sorted edge file to create.
+     * @param order BySource or ByDestination.
+     * @param memoryBytes Memory budget for the in-memory runs.
+     */
+    static void sort(const string &input, const string &output, EdgeOrder order, size_t memoryBytes);
+};
+
+#endif // EDGE_FILE_H
@@ -0,0 +1,201 @@
+#include "graph_reordering.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    /**
+     * @brief Returns the total (in + out) degree of every node.
+     */
+    vector<int> totalDegrees(const Graph &graph)
+    {
+        const vector<vector<int>> &adj = graph.getAdj();
+        const vector<vector<int>> &revAdj = graph.getRevAdj();
+        vector<int> degree(graph.getV());
+        for (int u = 0; u < graph.getV(); ++u)
+        {
+            degree[u] = adj[u].size() + revAdj[u].size();
+        }
+        return degree;
+    }
+
+    /**
+     * @brief Breadth-first traversal of the undirected graph from every unvisited node of seeds.
+     *
+     * @param graph The graph to traverse.
+     * @param seeds Candidate start nodes, in order of preference.
+     * @param degree Total degree of every node; used to order neighbours when byDegree is set.
+     * @param byDegree Visit the neighbours of a node by increasing degree (Cuthill-McKee).
+     * @return vector<int> The nodes in visiting order.
+     */
+    vector<int> breadthFirstOrder(const Graph &graph, const vector<int> &seeds,
+                                  const vector<int> &degree, bool byDegree)
+    {
+        const vector<vector<int>> &adj = graph.getAdj();
+        const vector<vector<int>> &revAdj = graph.getRevAdj();
+        int V = graph.getV();
+
+        vector<bool> visited(V, false);
+        vector<int> order;
+        order.reserve(V);
+        vector<int> neighbours;
+
+        for (int seed : seeds)
+        {
+            if (visited[seed])
+            {
+                continue;
+            }
+            visited[seed] = true;
+            order.push_back(seed);
+
+            // order doubles as the BFS queue
+            for (size_t head = order.size() - 1; head < order.size(); ++head)
+            {
+                int u = order[head];
+                neighbours.clear();
+                for (int v : adj[u])
+                {
+                    if (!visited[v])
+                    {
+                        visited[v] = true;
+                        neighbours.push_back(v);
+                    }
+                }
+                for (int v : revAdj[u])
+                {
+                    if (!visited[v])
+                    {
+                        visited[v] = true;
+                        neighbours.push_back(v);
+                    }
+                }
+                if (byDegree)
+                {
+                    stable_sort(neighbours.begin(), neighbours.end(),
+                                [&](int a, int b)
+                                { return degree[a] < degree[b]; });
+                }
+                order.insert(order.end(), neighbours.begin(), neighbours.end());
+            }
+        }
+        return order;
+    }
+}
+
+/**
+ * @brief Computes a locality-friendly order of the nodes of the graph.
+ *
+ * @param graph The graph to reorder.
+ * @param strategy The ordering heuristic to use.
+ * @return vector<int> newToOld permutation of the node IDs.
+ */
+vector<int> GraphReordering::computeOrder(const Graph &graph, ReorderStrategy strategy)
+{
+    int V = graph.getV();
+    vector<int> degree = totalDegrees(graph);
+    vector<int> nodes(V);
+    iota(nodes.begin(), nodes.end(), 0);
+
+    switch (strategy)
+    {
+    case ReorderStrategy::Degree:
+        stable_sort(nodes.begin(), nodes.end(),
+                    [&](int a, int b)
+                    { return degree[a] > degree[b]; });
+        return nodes;
+
+    case ReorderStrategy::BFS:
+        stable_sort(nodes.begin(), nodes.end(),
+                    [&](int a, int b)
+                    { return degree[a] > degree[b]; });
+        return breadthFirstOrder(graph, nodes, degree, false);
+
+    case ReorderStrategy::RCM:
+    default:
+    {
+        // Low degree nodes approximate peripheral nodes, the usual Cuthill-McKee start.
+        stable_sort(nodes.begin(), nodes.end(),
+                    [&](int a, int b)
+                    { return degree[a] < degree[b]; });
+        vector<int> order = breadthFirstOrder(graph, nodes, degree, true);
+        reverse(order.begin(), order.end());
+        return order;
+    }
+    }
+}
+
+/**
+ * @brief Builds a relabelled copy of the graph.
+ *
+ * Nodes are registered in the new order first, so that getId() hands out IDs 0..V-1
+ * in the order given by newToOld, then every edge is re-added by ID.
+ *
+ * @param graph The graph to relabel.
+ * @param newToOld Permutation returned by computeOrder().
+ * @return Graph The relabelled graph.
+ */
+Graph GraphReordering::apply(const Graph &graph, const vector<int> &newToOld)
+{
+    int V = graph.getV();
+    vector<int> oldToNew = invert(newToOld);
+    const vector<vector<int>> &adj = graph.getAdj();
+
+    Graph reordered(0);
+    for (int i = 0; i < V; ++i)
+    {
+        reordered.getId(graph.getName(newToOld[i]));
+    }
+
+    vector<int> targets;
+    for (int u = 0; u < V; ++u)
+    {
+        targets.clear();
+        for (int v : adj[newToOld[u]])
+        {
+            targets.push_back(oldToNew[v]);
+        }
+        sort(targets.begin(), targets.end());
+        for (int v : targets)
+        {
+            reordered.addEdgeById(u, v);
+        }
+    }
+    return reordered;
+}
+
+/**
+ * @brief Inverts a permutation.
+ *
+ * @param permutation The permutation to invert.
+ * @return vector<int> The inverse permutation.
+ */
+vector<int> GraphReordering::invert(const vector<int> &permutation)
+{
+    vector<int> inverse(permutation.size());
+    for (int i = 0; i < (int)permutation.size(); ++i)
+    {
+        inverse[permutation[i]] = i;
+    }
+    return inverse;
+}
+
+/**
+ * @brief Parses a strategy name.
+ *
+ * @param name "bfs", "rcm" or "degree".
+ * @param strategy Output receiving the parsed strategy.
+ * @return bool True if the name was recognised.
+ */
+bool GraphReordering::parseStrategy(const string &name, ReorderStrategy &strategy)
+{
+    if (name == "bfs")
+        strategy = ReorderStrategy::BFS;
+    else if (name == "rcm")
+        strategy = ReorderStrategy::RCM;
+    else if (name == "degree")
+        strategy = ReorderStrategy::Degree;
+    else
+        return false;
+    return true;
+}
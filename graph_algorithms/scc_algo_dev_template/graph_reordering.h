@@ -0,0 +1,78 @@
+#ifndef GRAPH_REORDERING_H
+#define GRAPH_REORDERING_H
+
+#include "directed_graph.h"
+
+/**
+ * @brief Vertex orderings that can be used to relabel a Graph.
+ */
+enum class ReorderStrategy
+{
+    /**
+     * @brief Breadth-first order over the undirected graph, starting from the highest degree node.
+     */
+    BFS,
+
+    /**
+     * @brief Reverse Cuthill-McKee: BFS from a low degree node visiting neighbours by increasing degree,
+     *        then reversed. Keeps the IDs of neighbouring nodes close together.
+     */
+    RCM,
+
+    /**
+     * @brief Nodes sorted by decreasing total degree so that hubs share cache lines.
+     */
+    Degree
+};
+
+/**
+ * @brief Relabels the nodes of a Graph into a locality-friendly order.
+ *
+ * Graph assigns IDs in first-seen order, which scatters the neighbours of a node across
+ * adj/revAdj. Relabelling so that nodes visited together have nearby IDs makes the DFS
+ * passes of KosarajuAlgorithm touch fewer cache lines. Node names are carried over, so
+ * results computed on the relabelled graph still resolve to the original names through
+ * Graph::getName().
+ */
+class GraphReordering
+{
+public:
+    /**
+     * @brief Computes a new order of the nodes of the graph.
+     *
+     * @param graph The graph to reorder.
+     * @param strategy The ordering heuristic to use.
+     * @return vector<int> newToOld, where newToOld[i] is the old ID of the node that gets ID i.
+     */
+    static vector<int> computeOrder(const Graph &graph, ReorderStrategy strategy);
+
+    /**
+     * @brief Builds a copy of the graph with its nodes relabelled.
+     *
+     * Adjacency lists of the new graph are sorted by ID.
+     *
+     * @param graph The graph to relabel.
+     * @param newToOld Permutation returned by computeOrder().
+     * @return Graph The relabelled graph.
+     */
+    static Graph apply(const Graph &graph, const vector<int> &newToOld);
+
+    /**
+     * @brief Inverts a permutation, turning newToOld into oldToNew (and vice versa).
+     *
+     * @param permutation The permutation to invert.
+     * @return vector<int> The inverse permutation.
+     */
+    static vector<int> invert(const vector<int> &permutation);
+
+    /**
+     * @brief Parses a strategy name ("bfs", "rcm" or "degree").
+     *
+     * @param name The name to parse.
+     * @param strategy Output receiving the parsed strategy.
+     * @return bool True if the name was recognised.
+     */
+    static bool parseStrategy(const string &name, ReorderStrategy &strategy);
+};
+
+#endif // GRAPH_REORDERING_H
@@ -0,0 +1,294 @@
+#include "graph_snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = {'S', 'C', 'C', 'S', 'N', 'A', 'P', '\0'};
+
+    /**
+     * @brief On-disk header; every section offset is relative to the start of the file
+     *        and 8-byte aligned.
+     */
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t vertices;
+        uint64_t edges;
+        uint64_t fileSize;
+        uint64_t nameOffsets;  // uint64_t[V + 1]
+        uint64_t names;        // char[nameBytes]
+        uint64_t idsByName;    // int32_t[V]
+        uint64_t adjOffsets;   // uint64_t[V + 1]
+        uint64_t adjTargets;   // int32_t[E]
+        uint64_t revOffsets;   // uint64_t[V + 1]
+        uint64_t revTargets;   // int32_t[E]
+    };
+
+    uint64_t align8(uint64_t offset)
+    {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    /**
+     * @brief True if count elements of elementSize bytes at offset lie after the header and
+     *        inside a file of length bytes, with the alignment save() gives every section.
+     */
+    bool sectionFits(uint64_t offset, uint64_t count, size_t elementSize, size_t length)
+    {
+        return offset >= sizeof(SnapshotHeader) && offset % 8 == 0 && offset <= length &&
+               count <= (length - offset) / elementSize;
+    }
+
+    /**
+     * @brief Writes an array at the given file offset, zero-padding up to it first.
+     */
+    void writeAt(ofstream &out, uint64_t offset, const void *data, size_t bytes)
+    {
+        static const char zeros[8] = {};
+        uint64_t position = out.tellp();
+        out.write(zeros, offset - position);
+        out.write(static_cast<const char *>(data), bytes);
+    }
+
+    /**
+     * @brief Flattens adjacency lists into CSR offsets and targets.
+     */
+    void toCsr(const vector<vector<int>> &lists, vector<uint64_t> &offsets, vector<int32_t> &targets)
+    {
+        offsets.assign(lists.size() + 1, 0);
+        for (size_t u = 0; u < lists.size(); ++u)
+        {
+            offsets[u + 1] = offsets[u] + lists[u].size();
+        }
+        targets.clear();
+        targets.reserve(offsets.back());
+        for (const vector<int> &list : lists)
+        {
+            targets.insert(targets.end(), list.begin(), list.end());
+        }
+    }
+}
+
+/**
+ * @brief Writes a snapshot of the graph to path.
+ *
+ * @param graph The graph to save.
+ * @param path Output file.
+ */
+void GraphSnapshot::save(const Graph &graph, const string &path)
+{
+    int V = graph.getV();
+
+    vector<uint64_t> nameOffsets(V + 1, 0);
+    string names;
+    for (int id = 0; id < V; ++id)
+    {
+        names += graph.getName(id);
+        nameOffsets[id + 1] = names.size();
+    }
+
+    // Compare views into the name table built above; Graph::getName() returns copies.
+    auto nameOf = [&](int id)
+    {
+        return string_view(names).substr(nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    };
+    vector<int32_t> idsByName(V);
+    iota(idsByName.begin(), idsByName.end(), 0);
+    sort(idsByName.begin(), idsByName.end(), [&](int a, int b)
+         { return nameOf(a) < nameOf(b); });
+
+    vector<uint64_t> adjOffsets, revOffsets;
+    vector<int32_t> adjTargets, revTargets;
+    toCsr(graph.getAdj(), adjOffsets, adjTargets);
+    toCsr(graph.getRevAdj(), revOffsets, revTargets);
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.vertices = V;
+    header.edges = adjTargets.size();
+    header.nameOffsets = align8(sizeof(SnapshotHeader));
+    header.names = align8(header.nameOffsets + nameOffsets.size() * sizeof(uint64_t));
+    header.idsByName = align8(header.names + names.size());
+    header.adjOffsets = align8(header.idsByName + idsByName.size() * sizeof(int32_t));
+    header.adjTargets = align8(header.adjOffsets + adjOffsets.size() * sizeof(uint64_t));
+    header.revOffsets = align8(header.adjTargets + adjTargets.size() * sizeof(int32_t));
+    header.revTargets = align8(header.revOffsets + revOffsets.size() * sizeof(uint64_t));
+    header.fileSize = header.revTargets + revTargets.size() * sizeof(int32_t);
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out)
+    {
+        throw runtime_error("cannot create snapshot " + path);
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeAt(out, header.nameOffsets, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    writeAt(out, header.names, names.data(), names.size());
+    writeAt(out, header.idsByName, idsByName.data(), idsByName.size() * sizeof(int32_t));
+    writeAt(out, header.adjOffsets, adjOffsets.data(), adjOffsets.size() * sizeof(uint64_t));
+    writeAt(out, header.adjTargets, adjTargets.data(), adjTargets.size() * sizeof(int32_t));
+    writeAt(out, header.revOffsets, revOffsets.data(), revOffsets.size() * sizeof(uint64_t));
+    writeAt(out, header.revTargets, revTargets.data(), revTargets.size() * sizeof(int32_t));
+    if (!out)
+    {
+        throw runtime_error("failed writing snapshot " + path);
+    }
+}
+
+/**
+ * @brief Maps a snapshot file and validates its header.
+ *
+ * Every section is checked to lie inside the mapping, and the last offset of each offset
+ * array to match the section it delimits, so a corrupt header cannot make lookups read past
+ * the end of the file. The contents of the arrays are trusted.
+ *
+ * @param path Snapshot file written by save().
+ */
+GraphSnapshot::GraphSnapshot(const string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw runtime_error("cannot open snapshot " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+    {
+        ::close(fd);
+        throw runtime_error(path + " is not a graph snapshot");
+    }
+    length = info.st_size;
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw runtime_error("cannot map snapshot " + path);
+    }
+    base = static_cast<const char *>(mapped);
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(base);
+    uint64_t vertices = header->vertices, edges = header->edges;
+    bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == VERSION && header->fileSize == length && vertices < INT32_MAX &&
+                 sectionFits(header->nameOffsets, vertices + 1, sizeof(uint64_t), length) &&
+                 sectionFits(header->idsByName, vertices, sizeof(int32_t), length) &&
+                 sectionFits(header->adjOffsets, vertices + 1, sizeof(uint64_t), length) &&
+                 sectionFits(header->adjTargets, edges, sizeof(int32_t), length) &&
+                 sectionFits(header->revOffsets, vertices + 1, sizeof(uint64_t), length) &&
+                 sectionFits(header->revTargets, edges, sizeof(int32_t), length) &&
+                 header->revTargets + edges * sizeof(int32_t) == length;
+    if (valid)
+    {
+        const uint64_t *nameEnd = reinterpret_cast<const uint64_t *>(base + header->nameOffsets) + vertices;
+        const uint64_t *adjEnd = reinterpret_cast<const uint64_t *>(base + header->adjOffsets) + vertices;
+        const uint64_t *revEnd = reinterpret_cast<const uint64_t *>(base + header->revOffsets) + vertices;
+        valid = header->names >= sizeof(SnapshotHeader) && header->names <= length &&
+                *nameEnd <= length - header->names && *adjEnd == edges && *revEnd == edges;
+    }
+    if (!valid)
+    {
+        munmap(const_cast<char *>(base), length);
+        throw runtime_error(path + " is not a version " + to_string(VERSION) + " graph snapshot");
+    }
+
+    V = header->vertices;
+    E = header->edges;
+    nameOffsets = reinterpret_cast<const uint64_t *>(base + header->nameOffsets);
+    names = base + header->names;
+    idsByName = reinterpret_cast<const int32_t *>(base + header->idsByName);
+    adj = {reinterpret_cast<const uint64_t *>(base + header->adjOffsets),
+           reinterpret_cast<const int32_t *>(base + header->adjTargets)};
+    revAdj = {reinterpret_cast<const uint64_t *>(base + header->revOffsets),
+              reinterpret_cast<const int32_t *>(base + header->revTargets)};
+}
+
+GraphSnapshot::~GraphSnapshot()
+{
+    munmap(const_cast<char *>(base), length);
+}
+
+/**
+ * @brief Returns the number of vertices in the graph.
+ */
+int GraphSnapshot::getV() const
+{
+    return V;
+}
+
+/**
+ * @brief Returns the number of edges in the graph.
+ */
+uint64_t GraphSnapshot::getE() const
+{
+    return E;
+}
+
+/**
+ * @brief Returns the forward edges in CSR form.
+ */
+const CsrAdjacency &GraphSnapshot::getAdj() const
+{
+    return adj;
+}
+
+/**
+ * @brief Returns the reverse edges in CSR form.
+ */
+const CsrAdjacency &GraphSnapshot::getRevAdj() const
+{
+    return revAdj;
+}
+
+/**
+ * @brief Returns the name of the node with the given ID.
+ *
+ * @param id The unique integer ID of the node.
+ * @return string_view The name, valid as long as the snapshot is open.
+ */
+string_view GraphSnapshot::getName(int id) const
+{
+    return string_view(names + nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+}
+
+/**
+ * @brief Looks up the ID of a node by binary search over the IDs sorted by name.
+ *
+ * @param name The name of the node.
+ * @return int The ID of the node, or -1 if absent.
+ */
+int GraphSnapshot::findId(string_view name) const
+{
+    const int32_t *it = lower_bound(idsByName, idsByName + V, name, [&](int32_t id, string_view key)
+                                    { return getName(id) < key; });
+    if (it != idsByName + V && getName(*it) == name)
+    {
+        return *it;
+    }
+    return -1;
+}
+
+/**
+ * @brief Displays the graph's adjacency list.
+ */
+void GraphSnapshot::displayGraph() const
+{
+    for (int i = 0; i < V; ++i)
+    {
+        cout << getName(i) << " -> ";
+        for (int v : adj[i])
+        {
+            cout << getName(v) << " ";
+        }
+        cout << endl;
+    }
+}
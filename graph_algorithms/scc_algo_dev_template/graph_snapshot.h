@@ -0,0 +1,173 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "directed_graph.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief Read-only adjacency in compressed sparse row (CSR) form.
+ *
+ * adjacency[u] yields the targets of node u, so the same traversal code can walk both
+ * a CSR array and a vector<vector<int>>.
+ */
+struct CsrAdjacency
+{
+    /**
+     * @brief Contiguous range of neighbour IDs.
+     */
+    struct Range
+    {
+        const int32_t *first;
+        const int32_t *last;
+
+        const int32_t *begin() const { return first; }
+        const int32_t *end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    /**
+     * @brief offsets[u]..offsets[u + 1] delimit the neighbours of u in targets.
+     */
+    const uint64_t *offsets;
+
+    /**
+     * @brief Neighbour IDs of all nodes, back to back.
+     */
+    const int32_t *targets;
+
+    Range operator[](int u) const
+    {
+        return {targets + offsets[u], targets + offsets[u + 1]};
+    }
+};
+
+/**
+ * @brief Versioned binary snapshot of a Graph, loaded through mmap as a read-only view.
+ *
+ * The snapshot holds the name table, the name-to-ID mapping (IDs sorted by name, searched
+ * with binary search) and the forward and reverse edges in CSR form. Opening a snapshot
+ * maps the file and validates its header; nothing is parsed and no per-node memory is
+ * allocated, so repeated analyses of the same graph skip ingestion entirely.
+ */
+class GraphSnapshot
+{
+private:
+    /**
+     * @brief Start of the mapped file.
+     */
+    const char *base;
+
+    /**
+     * @brief Size of the mapped file in bytes.
+     */
+    size_t length;
+
+    /**
+     * @brief Number of nodes.
+     */
+    int V;
+
+    /**
+     * @brief Number of edges.
+     */
+    uint64_t E;
+
+    /**
+     * @brief nameOffsets[id]..nameOffsets[id + 1] delimit the name of id in names.
+     */
+    const uint64_t *nameOffsets;
+
+    /**
+     * @brief All node names, back to back.
+     */
+    const char *names;
+
+    /**
+     * @brief Node IDs ordered by name.
+     */
+    const int32_t *idsByName;
+
+    /**
+     * @brief Forward edges.
+     */
+    CsrAdjacency adj;
+
+    /**
+     * @brief Reverse edges.
+     */
+    CsrAdjacency revAdj;
+
+public:
+    /**
+     * @brief Current version of the snapshot format.
+     */
+    static const uint32_t VERSION = 1;
+
+    /**
+     * @brief Writes a snapshot of the graph to path.
+     *
+     * @param graph The graph to save.
+     * @param path Output file.
+     */
+    static void save(const Graph &graph, const string &path);
+
+    /**
+     * @brief Maps the snapshot at path.
+     *
+     * Throws runtime_error if the file is missing, truncated or of another version.
+     *
+     * @param path Snapshot file written by save().
+     */
+    explicit GraphSnapshot(const string &path);
+
+    ~GraphSnapshot();
+
+    GraphSnapshot(const GraphSnapshot &) = delete;
+    GraphSnapshot &operator=(const GraphSnapshot &) = delete;
+
+    /**
+     * @brief Returns the number of vertices in the graph.
+     */
+    int getV() const;
+
+    /**
+     * @brief Returns the number of edges in the graph.
+     */
+    uint64_t getE() const;
+
+    /**
+     * @brief Returns the forward edges in CSR form.
+     */
+    const CsrAdjacency &getAdj() const;
+
+    /**
+     * @brief Returns the reverse edges in CSR form.
+     */
+    const CsrAdjacency &getRevAdj() const;
+
+    /**
+     * @brief Returns the name of the node with the given ID, pointing into the mapped file.
+     *
+     * @param id The unique integer ID of the node.
+     */
+    string_view getName(int id) const;
+
+    /**
+     * @brief Looks up the ID of a node by name.
+     *
+     * @param name The name of the node.
+     * @return int The ID of the node, or -1 if the graph has no such node.
+     */
+    int findId(string_view name) const;
+
+    /**
+     * @brief Displays the graph's adjacency list.
+     */
+    void displayGraph() const;
+};
+
+#endif // GRAPH_SNAPSHOT_H
@@ -0,0 +1,236 @@
+#include "scc_instrumentation.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+namespace
+{
+    /**
+     * @brief Writes s as a JSON string literal.
+     */
+    void writeString(ostream &out, const string &s)
+    {
+        out << '"';
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\' << c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                const char *hex = "0123456789abcdef";
+                out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+            }
+            else
+            {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    /**
+     * @brief Index of the power-of-two bucket [2^k, 2^(k+1)) holding size (size >= 1).
+     */
+    int bucketOf(uint64_t size)
+    {
+        return 63 - __builtin_clzll(size);
+    }
+}
+
+SccInstrumentation::SccInstrumentation(const string &engine)
+    : engine(engine), vertices(0), edges(0), running(-1), maxDepth(0), components(0), largestComponent(0)
+{
+}
+
+void SccInstrumentation::setGraph(uint64_t vertices, uint64_t edges)
+{
+    this->vertices = vertices;
+    this->edges = edges;
+}
+
+/**
+ * @brief Ends the running phase, if any, and starts timing the named one.
+ *
+ * @param name Phase name; a phase that already exists is resumed and accumulates.
+ */
+void SccInstrumentation::beginPhase(const string &name)
+{
+    endPhase();
+    auto it = find_if(phases.begin(), phases.end(), [&](const Phase &p)
+                      { return p.name == name; });
+    if (it == phases.end())
+    {
+        phases.push_back({name, 0.0, 0, 0});
+        it = phases.end() - 1;
+    }
+    running = it - phases.begin();
+    phaseStart = chrono::steady_clock::now();
+}
+
+void SccInstrumentation::endPhase()
+{
+    if (running < 0)
+    {
+        return;
+    }
+    Phase &phase = phases[running];
+    phase.seconds += chrono::duration<double>(chrono::steady_clock::now() - phaseStart).count();
+    phase.peakRssBytes = peakRssBytes();
+    running = -1;
+}
+
+void SccInstrumentation::addEdgesScanned(uint64_t edges)
+{
+    if (running >= 0)
+    {
+        phases[running].edgesScanned += edges;
+    }
+}
+
+void SccInstrumentation::noteDfsDepth(uint64_t depth)
+{
+    maxDepth = max(maxDepth, depth);
+}
+
+void SccInstrumentation::addComponent(uint64_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    ++components;
+    largestComponent = max(largestComponent, size);
+    size_t bucket = bucketOf(size);
+    if (sizeBuckets.size() <= bucket)
+    {
+        sizeBuckets.resize(bucket + 1, 0);
+    }
+    ++sizeBuckets[bucket];
+}
+
+void SccInstrumentation::addComponents(const vector<vector<int>> &components)
+{
+    for (const vector<int> &component : components)
+    {
+        addComponent(component.size());
+    }
+}
+
+void SccInstrumentation::setCounter(const string &name, uint64_t value)
+{
+    for (auto &counter : counters)
+    {
+        if (counter.first == name)
+        {
+            counter.second = value;
+            return;
+        }
+    }
+    counters.emplace_back(name, value);
+}
+
+uint64_t SccInstrumentation::maxDfsDepth() const
+{
+    return maxDepth;
+}
+
+uint64_t SccInstrumentation::componentCount() const
+{
+    return components;
+}
+
+double SccInstrumentation::totalSeconds() const
+{
+    double total = 0;
+    for (const Phase &phase : phases)
+    {
+        total += phase.seconds;
+    }
+    return total;
+}
+
+/**
+ * @brief Writes the record as one JSON object on a single line.
+ *
+ * Layout:
+ *   {"engine", "vertices", "edges", "total_seconds", "max_dfs_depth", "peak_rss_bytes",
+ *    "phases": [{"name", "seconds", "edges_scanned", "peak_rss_bytes"}],
+ *    "components": {"count", "largest", "histogram": [{"min_size", "max_size", "count"}]},
+ *    "counters": {name: value}}
+ * A phase still running is reported up to now. SCCEngine::print_stats() in
+ * scc_algo_cp_template/cp_template.cpp writes the same layout by hand; keep it in sync.
+ *
+ * @param out Stream receiving the JSON text.
+ */
+void SccInstrumentation::writeJson(ostream &out) const
+{
+    out << "{\"engine\":";
+    writeString(out, engine);
+    out << ",\"vertices\":" << vertices << ",\"edges\":" << edges << ",\"total_seconds\":" << totalSeconds()
+        << ",\"max_dfs_depth\":" << maxDepth << ",\"peak_rss_bytes\":" << peakRssBytes() << ",\"phases\":[";
+    for (size_t i = 0; i < phases.size(); ++i)
+    {
+        const Phase &phase = phases[i];
+        double seconds = phase.seconds;
+        if ((int)i == running)
+        {
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - phaseStart).count();
+        }
+        out << (i ? "," : "") << "{\"name\":";
+        writeString(out, phase.name);
+        out << ",\"seconds\":" << seconds << ",\"edges_scanned\":" << phase.edgesScanned
+            << ",\"peak_rss_bytes\":" << phase.peakRssBytes << "}";
+    }
+    out << "],\"components\":{\"count\":" << components << ",\"largest\":" << largestComponent << ",\"histogram\":[";
+    bool first = true;
+    for (size_t k = 0; k < sizeBuckets.size(); ++k)
+    {
+        if (sizeBuckets[k] == 0)
+        {
+            continue;
+        }
+        out << (first ? "" : ",") << "{\"min_size\":" << (uint64_t(1) << k)
+            << ",\"max_size\":" << (uint64_t(2) << k) - 1 << ",\"count\":" << sizeBuckets[k] << "}";
+        first = false;
+    }
+    out << "]},\"counters\":{";
+    for (size_t i = 0; i < counters.size(); ++i)
+    {
+        out << (i ? "," : "");
+        writeString(out, counters[i].first);
+        out << ":" << counters[i].second;
+    }
+    out << "}}";
+}
+
+void SccInstrumentation::writeJson(const string &path) const
+{
+    if (path == "-")
+    {
+        writeJson(cerr);
+        cerr << "\n";
+        return;
+    }
+    ofstream out(path);
+    writeJson(out);
+    out << "\n";
+    if (!out)
+    {
+        throw runtime_error("cannot write " + path);
+    }
+}
+
+uint64_t SccInstrumentation::peakRssBytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss; // already in bytes on macOS
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
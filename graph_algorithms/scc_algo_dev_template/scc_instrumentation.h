@@ -0,0 +1,124 @@
+#ifndef SCC_INSTRUMENTATION_H
+#define SCC_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Opt-in measurements of one SCC run, written out as a JSON object.
+ *
+ * Engines take an optional SccInstrumentation pointer and record into it only when it is
+ * non-null; their uninstrumented paths are compiled without any counting. The caller owns
+ * the object, so phases outside the engine (reading the input, printing the output) can
+ * be timed into the same record.
+ *
+ * Collected per run:
+ * - wall time, edges scanned and process peak RSS at the end of every phase; phases with
+ *   the same name (e.g. one per round) are merged,
+ * - the deepest DFS stack reached,
+ * - a histogram of component sizes in power-of-two buckets,
+ * - named engine-specific counters.
+ */
+class SccInstrumentation
+{
+private:
+    struct Phase
+    {
+        string name;
+        double seconds;
+        uint64_t edgesScanned;
+        uint64_t peakRssBytes;
+    };
+
+    string engine;
+    uint64_t vertices;
+    uint64_t edges;
+    vector<Phase> phases;
+    int running;
+    chrono::steady_clock::time_point phaseStart;
+    uint64_t maxDepth;
+    uint64_t components;
+    uint64_t largestComponent;
+    vector<uint64_t> sizeBuckets;
+    vector<pair<string, uint64_t>> counters;
+
+public:
+    /**
+     * @param engine Name of the engine being measured, e.g. "dev-kosaraju".
+     */
+    explicit SccInstrumentation(const string &engine);
+
+    /**
+     * @brief Records the size of the input graph.
+     */
+    void setGraph(uint64_t vertices, uint64_t edges);
+
+    /**
+     * @brief Ends the running phase, if any, and starts timing the named one.
+     */
+    void beginPhase(const string &name);
+
+    /**
+     * @brief Ends the running phase, adding its time to the phase of the same name.
+     */
+    void endPhase();
+
+    /**
+     * @brief Adds edges scanned to the running phase.
+     */
+    void addEdgesScanned(uint64_t edges);
+
+    /**
+     * @brief Raises the maximum DFS depth to depth if it is deeper.
+     */
+    void noteDfsDepth(uint64_t depth);
+
+    /**
+     * @brief Counts one component of the given size.
+     */
+    void addComponent(uint64_t size);
+
+    /**
+     * @brief Counts every component of a list, as returned by findComponents().
+     */
+    void addComponents(const vector<vector<int>> &components);
+
+    /**
+     * @brief Sets a named engine-specific counter, replacing an earlier value.
+     */
+    void setCounter(const string &name, uint64_t value);
+
+    uint64_t maxDfsDepth() const;
+
+    uint64_t componentCount() const;
+
+    /**
+     * @brief Sum of the wall time of all finished phases.
+     */
+    double totalSeconds() const;
+
+    /**
+     * @brief Writes the record as one JSON object on a single line.
+     */
+    void writeJson(ostream &out) const;
+
+    /**
+     * @brief Writes the record followed by a newline to a file, or to stderr if path is "-".
+     *
+     * @throws runtime_error if the file cannot be written.
+     */
+    void writeJson(const string &path) const;
+
+    /**
+     * @brief Returns the peak resident set size of the process so far, in bytes.
+     */
+    static uint64_t peakRssBytes();
+};
+
+#endif // SCC_INSTRUMENTATION_H
@@ -0,0 +1,192 @@
+#include "edge_file.h"
+#include "semi_external_scc.h"
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace
+{
+    /**
+     * @brief Converts a text edge list ("source destination" names) into the on-disk format.
+     *
+     * Writes <prefix>.names (one name per line, in ID order), <prefix>.fwd (edges sorted by
+     * source) and <prefix>.bwd (edges sorted by destination). Only the name table is held in
+     * memory; the edges are sorted externally within memoryBytes.
+     */
+    void convert(const string &input, const string &prefix, size_t memoryBytes)
+    {
+        ifstream in(input);
+        if (!in)
+        {
+            throw runtime_error("cannot open " + input);
+        }
+        ofstream names(prefix + ".names");
+
+        unordered_map<string, uint32_t> nameToId;
+        auto idOf = [&](const string &name)
+        {
+            auto it = nameToId.find(name);
+            if (it != nameToId.end())
+            {
+                return it->second;
+            }
+            uint32_t id = nameToId.size();
+            nameToId.emplace(name, id);
+            names << name << '\n';
+            return id;
+        };
+
+        string raw = prefix + ".raw";
+        {
+            EdgeFileWriter writer(raw, 1 << 20);
+            string u, v;
+            while (in >> u >> v)
+            {
+                uint32_t a = idOf(u);
+                uint32_t b = idOf(v);
+                writer.write({a, b});
+            }
+            writer.close(nameToId.size(), EdgeOrder::Unsorted);
+        }
+        nameToId.clear();
+
+        EdgeFileSorter::sort(raw, prefix + ".fwd", EdgeOrder::BySource, memoryBytes);
+        EdgeFileSorter::sort(raw, prefix + ".bwd", EdgeOrder::ByDestination, memoryBytes);
+        remove(raw.c_str());
+    }
+
+    /**
+     * @brief Runs the semi-external SCC algorithm and prints the SCCs like the interactive tool.
+     *
+     * @param statsJson If not empty, file ("-" for stderr) receiving the run's instrumentation as JSON.
+     */
+    void run(const string &prefix, size_t bufferBytes, const string &statsJson)
+    {
+        SemiExternalStats stats;
+        SccInstrumentation instrumentation("semi-external");
+        SccInstrumentation *record = statsJson.empty() ? nullptr : &instrumentation;
+        vector<uint32_t> comp = SemiExternalScc::run(prefix + ".fwd", prefix + ".bwd", bufferBytes, &stats, record);
+
+        vector<string> names;
+        names.reserve(comp.size());
+        ifstream in(prefix + ".names");
+        string name;
+        while (getline(in, name))
+        {
+            names.push_back(name);
+        }
+
+        // Group nodes by representative with a counting sort; O(V) memory.
+        uint32_t V = comp.size();
+        vector<uint32_t> start(V + 1, 0);
+        for (uint32_t v = 0; v < V; ++v)
+        {
+            ++start[comp[v] + 1];
+        }
+        for (uint32_t i = 0; i < V; ++i)
+        {
+            start[i + 1] += start[i];
+        }
+        vector<uint32_t> members(V);
+        vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (uint32_t v = 0; v < V; ++v)
+        {
+            members[fill[comp[v]]++] = v;
+        }
+
+        if (record != nullptr)
+        {
+            record->beginPhase("output");
+        }
+        cout << "Strongly Connected Components (semi-external):\n";
+        int sccCount = 0;
+        for (uint32_t r = 0; r < V; ++r)
+        {
+            if (start[r] == start[r + 1])
+            {
+                continue;
+            }
+            cout << "SCC #" << ++sccCount << ": ";
+            for (uint32_t i = start[r]; i < start[r + 1]; ++i)
+            {
+                cout << (members[i] < names.size() ? names[members[i]] : to_string(members[i])) << " ";
+            }
+            cout << "\n";
+        }
+
+        cerr << "nodes: " << V << ", SCCs: " << sccCount << ", rounds: " << stats.rounds
+             << ", trimmed: " << stats.trimmed << ", passes: " << stats.passes
+             << ", edges streamed: " << stats.edgesStreamed << "\n";
+
+        if (record != nullptr)
+        {
+            cout.flush();
+            record->endPhase();
+            record->writeJson(statsJson);
+        }
+    }
+
+    void usage(const char *prog)
+    {
+        cerr << "Usage: " << prog << " convert <edges.txt> <prefix> [memory MB]\n"
+             << "       " << prog << " run <prefix> [buffer MB] [--stats-json <file>]\n";
+        exit(1);
+    }
+}
+
+/**
+ * @brief Semi-external SCC tool for graphs whose edges do not fit in memory.
+ *
+ * "convert" turns a text edge list into sorted binary edge files once; "run" then computes
+ * the SCCs keeping only O(V) state in memory. With --stats-json, "run" also writes per-phase
+ * timings and counters as JSON ("-" for stderr).
+ *
+ * @return int Exit status of the program.
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        usage(argv[0]);
+    }
+    string command = argv[1];
+    try
+    {
+        if (command == "convert" && argc >= 4)
+        {
+            size_t memoryMB = argc >= 5 ? stoul(argv[4]) : 256;
+            convert(argv[2], argv[3], memoryMB << 20);
+        }
+        else if (command == "run")
+        {
+            size_t bufferMB = 16;
+            string statsJson;
+            for (int i = 3; i < argc; ++i)
+            {
+                string arg = argv[i];
+                if (arg == "--stats-json" && i + 1 < argc)
+                {
+                    statsJson = argv[++i];
+                }
+                else
+                {
+                    bufferMB = stoul(arg);
+                }
+            }
+            run(argv[2], bufferMB << 20, statsJson);
+        }
+        else
+        {
+            usage(argv[0]);
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include "semi_external_scc.h"
+#include <stdexcept>
+
+namespace
+{
+    const uint32_t UNASSIGNED = UINT32_MAX;
+
+    /**
+     * @brief State shared by the passes of one semi-external run; everything here is O(V).
+     */
+    struct SemiExternalState
+    {
+        EdgeFileReader &forward;
+        EdgeFileReader &backward;
+        vector<uint32_t> &comp;
+        vector<uint32_t> scratch; // colour, or in-degree while trimming
+        vector<uint32_t> outDegree;
+        uint64_t remaining;
+        bool reverseForward;
+        bool reverseBackward;
+        uint64_t passes;
+
+        bool alive(uint32_t v) const
+        {
+            return comp[v] == UNASSIGNED;
+        }
+
+        /**
+         * @brief Rewinds a reader for the next pass, alternating the scan direction of each file.
+         */
+        void startPass(EdgeFileReader &reader)
+        {
+            bool &reverse = &reader == &forward ? reverseForward : reverseBackward;
+            reader.rewind(reverse);
+            reverse = !reverse;
+            ++passes;
+        }
+
+        void assign(uint32_t v, uint32_t representative)
+        {
+            comp[v] = representative;
+            --remaining;
+        }
+    };
+
+    /**
+     * @brief Repeatedly removes nodes with no remaining in-edges or no remaining out-edges.
+     *
+     * Edges of a node are contiguous in the file sorted by its endpoint, so a node found dead at
+     * the start of its group can release its neighbours in the same pass.
+     *
+     * @return uint64_t Number of nodes resolved as singleton SCCs.
+     */
+    uint64_t trim(SemiExternalState &s)
+    {
+        vector<uint32_t> &inDegree = s.scratch;
+        vector<uint32_t> &outDegree = s.outDegree;
+        fill(inDegree.begin(), inDegree.end(), 0);
+        fill(outDegree.begin(), outDegree.end(), 0);
+
+        Edge e;
+        s.startPass(s.forward);
+        while (s.forward.next(e))
+        {
+            if (s.alive(e.src) && s.alive(e.dst))
+            {
+                ++outDegree[e.src];
+                ++inDegree[e.dst];
+            }
+        }
+
+        uint64_t trimmed = 0;
+        uint64_t removed;
+        do
+        {
+            removed = 0;
+
+            // Nodes without in-edges, grouped by source.
+            uint32_t current = UNASSIGNED;
+            bool dying = false;
+            s.startPass(s.forward);
+            while (s.forward.next(e))
+            {
+                if (e.src != current)
+                {
+                    current = e.src;
+                    dying = s.alive(current) && inDegree[current] == 0;
+                    if (dying)
+                    {
+                        s.assign(current, current);
+                        ++removed;
+                    }
+                }
+                if (dying && s.alive(e.dst))
+                {
+                    --inDegree[e.dst];
+                }
+            }
+
+            // Nodes without out-edges, grouped by destination.
+            current = UNASSIGNED;
+            dying = false;
+            s.startPass(s.backward);
+            while (s.backward.next(e))
+            {
+                if (e.dst != current)
+                {
+                    current = e.dst;
+                    dying = s.alive(current) && outDegree[current] == 0;
+                    if (dying)
+                    {
+                        s.assign(current, current);
+                        ++removed;
+                    }
+                }
+                if (dying && s.alive(e.src))
+                {
+                    --outDegree[e.src];
+                }
+            }
+
+            // Isolated nodes never start a group in either file.
+            for (uint32_t v = 0; v < s.comp.size(); ++v)
+            {
+                if (s.alive(v) && inDegree[v] == 0 && outDegree[v] == 0)
+                {
+                    s.assign(v, v);
+                    ++removed;
+                }
+            }
+            trimmed += removed;
+        } while (removed > 0 && s.remaining > 0);
+
+        return trimmed;
+    }
+
+    /**
+     * @brief Propagates the largest (or smallest) node ID along forward edges until no colour changes.
+     *
+     * A chain of SCCs whose IDs decrease along the edges takes one round per SCC with the largest
+     * ID but a single round with the smallest, and vice versa, so rounds alternate between the two.
+     */
+    void colour(SemiExternalState &s, bool useLargest)
+    {
+        vector<uint32_t> &colour = s.scratch;
+        for (uint32_t v = 0; v < s.comp.size(); ++v)
+        {
+            colour[v] = v;
+        }
+
+        bool changed = true;
+        Edge e;
+        while (changed)
+        {
+            changed = false;
+            s.startPass(s.forward);
+            while (s.forward.next(e))
+            {
+                bool wins = useLargest ? colour[e.src] > colour[e.dst] : colour[e.src] < colour[e.dst];
+                if (wins && s.alive(e.src) && s.alive(e.dst))
+                {
+                    colour[e.dst] = colour[e.src];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Collects, for every colour root, the nodes of its colour that reach it, and assigns them.
+     *
+     * @return uint64_t Number of nodes assigned to a component.
+     */
+    uint64_t reachRoots(SemiExternalState &s)
+    {
+        const vector<uint32_t> &colour = s.scratch;
+        vector<bool> reached(s.comp.size(), false);
+        for (uint32_t v = 0; v < s.comp.size(); ++v)
+        {
+            reached[v] = s.alive(v) && colour[v] == v;
+        }
+
+        bool changed = true;
+        Edge e;
+        while (changed)
+        {
+            changed = false;
+            s.startPass(s.backward);
+            while (s.backward.next(e))
+            {
+                if (reached[e.dst] && !reached[e.src] && s.alive(e.src) && colour[e.src] == colour[e.dst])
+                {
+                    reached[e.src] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        uint64_t assigned = 0;
+        for (uint32_t v = 0; v < s.comp.size(); ++v)
+        {
+            if (reached[v])
+            {
+                s.assign(v, colour[v]);
+                ++assigned;
+            }
+        }
+        return assigned;
+    }
+}
+
+/**
+ * @brief Runs the semi-external SCC algorithm on a pair of sorted edge files.
+ *
+ * @param forwardPath Edge file sorted by source.
+ * @param backwardPath The same edges sorted by destination.
+ * @param bufferBytes Read buffer size of each of the two files.
+ * @param stats Optional output receiving pass and I/O counters.
+ * @param instrumentation Optional output receiving per-phase times, edges and component sizes.
+ * @return vector<uint32_t> For every node, the ID of the representative of its SCC.
+ */
+vector<uint32_t> SemiExternalScc::run(const string &forwardPath, const string &backwardPath,
+                                      size_t bufferBytes, SemiExternalStats *stats,
+                                      SccInstrumentation *instrumentation)
+{
+    EdgeFileReader forward(forwardPath, bufferBytes);
+    EdgeFileReader backward(backwardPath, bufferBytes);
+    if (forward.header().order != static_cast<uint32_t>(EdgeOrder::BySource) ||
+        backward.header().order != static_cast<uint32_t>(EdgeOrder::ByDestination) ||
+        forward.header().vertices != backward.header().vertices)
+    {
+        throw runtime_error("expected matching edge files sorted by source and by destination");
+    }
+
+    uint64_t V = forward.header().vertices;
+    vector<uint32_t> comp(V, UNASSIGNED);
+    SemiExternalState s{forward, backward, comp, vector<uint32_t>(V), vector<uint32_t>(V), V, false, false, 0};
+
+    // Ends the running phase, charging it the edges streamed since the previous switch, and
+    // starts the named one; a phase per round would drown the output, so rounds accumulate.
+    uint64_t edgesMark = 0;
+    auto switchPhase = [&](const char *name)
+    {
+        if (instrumentation == nullptr)
+        {
+            return;
+        }
+        uint64_t edgesRead = forward.totalEdgesRead() + backward.totalEdgesRead();
+        instrumentation->addEdgesScanned(edgesRead - edgesMark);
+        edgesMark = edgesRead;
+        if (name != nullptr)
+        {
+            instrumentation->beginPhase(name);
+        }
+        else
+        {
+            instrumentation->endPhase();
+        }
+    };
+    if (instrumentation != nullptr)
+    {
+        instrumentation->setGraph(V, forward.header().edges);
+    }
+
+    uint64_t rounds = 0, trimmed = 0;
+    while (s.remaining > 0)
+    {
+        ++rounds;
+        switchPhase("trim");
+        trimmed += trim(s);
+        if (s.remaining == 0)
+        {
+            break;
+        }
+        switchPhase("colour");
+        colour(s, rounds % 2 == 1);
+        switchPhase("reach");
+        reachRoots(s);
+    }
+    switchPhase(nullptr);
+
+    if (stats != nullptr)
+    {
+        stats->passes = s.passes;
+        stats->edgesStreamed = forward.totalEdgesRead() + backward.totalEdgesRead();
+        stats->rounds = rounds;
+        stats->trimmed = trimmed;
+    }
+    if (instrumentation != nullptr)
+    {
+        // Component sizes by representative; scratch is free again.
+        vector<uint32_t> &size = s.scratch;
+        fill(size.begin(), size.end(), 0);
+        for (uint32_t representative : comp)
+        {
+            ++size[representative];
+        }
+        for (uint32_t count : size)
+        {
+            instrumentation->addComponent(count);
+        }
+        instrumentation->setCounter("rounds", rounds);
+        instrumentation->setCounter("passes", s.passes);
+        instrumentation->setCounter("trimmed", trimmed);
+        instrumentation->setCounter("edges_streamed", forward.totalEdgesRead() + backward.totalEdgesRead());
+        instrumentation->setCounter("buffer_bytes", bufferBytes);
+    }
+    return comp;
+}
@@ -0,0 +1,74 @@
+#ifndef SEMI_EXTERNAL_SCC_H
+#define SEMI_EXTERNAL_SCC_H
+
+#include "edge_file.h"
+#include "scc_instrumentation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Counters describing the work done by a semi-external SCC run.
+ */
+struct SemiExternalStats
+{
+    /**
+     * @brief Number of full sequential scans over an edge file.
+     */
+    uint64_t passes = 0;
+
+    /**
+     * @brief Total number of edges read from disk.
+     */
+    uint64_t edgesStreamed = 0;
+
+    /**
+     * @brief Number of trim / colour / reach rounds.
+     */
+    uint64_t rounds = 0;
+
+    /**
+     * @brief Number of nodes resolved as singleton SCCs by trimming.
+     */
+    uint64_t trimmed = 0;
+};
+
+/**
+ * @brief Finds strongly connected components of graphs whose edges do not fit in memory.
+ *
+ * Only O(V) node state lives in memory; edges are streamed from two binary edge files,
+ * one sorted by source (forward passes) and one sorted by destination (backward passes).
+ * Each round:
+ * 1. Trim: nodes without remaining in- or out-edges are singleton SCCs.
+ * 2. Colour: the largest node ID (smallest on even rounds) is propagated along forward
+ *    edges until a fixpoint.
+ * 3. Reach: from every node whose colour is its own ID, backward edges inside the same
+ *    colour are followed; the nodes reached form the SCC of that root.
+ *
+ * Consecutive passes over a file alternate their scan direction so that chains oriented
+ * either way converge in a few passes. In the worst case the number of rounds still grows
+ * with the depth of the SCC DAG.
+ */
+class SemiExternalScc
+{
+public:
+    /**
+     * @brief Runs the semi-external SCC algorithm.
+     *
+     * @param forwardPath Edge file sorted by source.
+     * @param backwardPath The same edges sorted by destination.
+     * @param bufferBytes Read buffer size of each of the two files.
+     * @param stats Optional output receiving pass and I/O counters.
+     * @param instrumentation Optional; receives the "trim", "colour" and "reach" phases summed
+     *                        over all rounds with the edges each streamed, the component sizes
+     *                        and the SemiExternalStats counters.
+     * @return vector<uint32_t> For every node, the ID of the representative of its SCC.
+     */
+    static vector<uint32_t> run(const string &forwardPath, const string &backwardPath,
+                                size_t bufferBytes, SemiExternalStats *stats = nullptr,
+                                SccInstrumentation *instrumentation = nullptr);
+};
+
+#endif // SEMI_EXTERNAL_SCC_H
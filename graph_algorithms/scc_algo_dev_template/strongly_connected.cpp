@@ -16,92 +16,283 @@ namespace
     stack<int> finishStack;
     int V;
 
+    /**
+     * @brief Counter policy of an uninstrumented run; every hook compiles away.
+     */
+    struct NoCounters
+    {
+        static constexpr bool enabled = false;
+
+        void enter() {}
+        void leave() {}
+        void scan(size_t) {}
+    };
+
+    /**
+     * @brief Counter policy of an instrumented run: recursion depth and edges scanned.
+     */
+    struct DfsCounters
+    {
+        static constexpr bool enabled = true;
+
+        uint64_t depth = 0;
+        uint64_t maxDepth = 0;
+        uint64_t edges = 0;
+
+        void enter()
+        {
+            maxDepth = max(maxDepth, ++depth);
+        }
+
+        void leave()
+        {
+            --depth;
+        }
+
+        void scan(size_t count)
+        {
+            edges += count;
+        }
+    };
+
     /**
      * @brief Performs DFS traversal to fill the finish stack based on finishing times.
      *
      * @param graph Adjacency list representation of the directed graph.
      * @param u Current vertex being visited.
+     * @param counters NoCounters or DfsCounters.
      */
-    void dfsFillOrder(const vector<vector<int>> &graph, int u)
+    template <typename Adjacency, typename Counters>
+    void dfsFillOrder(const Adjacency &graph, int u, Counters &counters)
     {
+        counters.enter();
+        counters.scan(graph[u].size());
         visited[u] = true;
         for (int v : graph[u])
         {
             if (!visited[v])
             {
-                dfsFillOrder(graph, v);
+                dfsFillOrder(graph, v, counters);
             }
         }
         finishStack.push(u);
+        counters.leave();
     }
 
     /**
-     * @brief Performs DFS traversal on the reversed graph and prints the nodes in the SCC.
+     * @brief Performs DFS traversal on the reversed graph and collects the nodes in the SCC.
      *
      * @param graph Adjacency list representation of the reversed graph.
      * @param u Current vertex being visited.
-     * @param directed_graph Reference to the original Graph object (to map IDs to names).
+     * @param component Output vector receiving the IDs of the nodes in the current SCC.
+     * @param counters NoCounters or DfsCounters.
      */
-    void dfsOnReversedGraph(const vector<vector<int>> &graph, int u, Graph &directed_graph)
+    template <typename Adjacency, typename Counters>
+    void dfsOnReversedGraph(const Adjacency &graph, int u, vector<int> &component, Counters &counters)
     {
+        counters.enter();
+        counters.scan(graph[u].size());
         visited[u] = true;
-        cout << directed_graph.getName(u) << " ";
+        component.push_back(u);
         for (int v : graph[u])
         {
             if (!visited[v])
             {
-                dfsOnReversedGraph(graph, v, directed_graph);
+                dfsOnReversedGraph(graph, v, component, counters);
+            }
+        }
+        counters.leave();
+    }
+
+    /**
+     * @brief Kosaraju's two passes over any adjacency type indexable by node ID
+     *        (vector<vector<int>> or CsrAdjacency).
+     *
+     * @param vertices Number of nodes.
+     * @param adj Forward adjacency.
+     * @param revAdj Reverse adjacency.
+     * @param counters NoCounters, or DfsCounters to collect the statistics of both passes.
+     * @param instrumentation Receives the "reverse_dfs" phase, the caller having started
+     *                        "first_dfs"; only used with DfsCounters.
+     * @return vector<vector<int>> The SCCs in discovery order.
+     */
+    template <typename Adjacency, typename Counters>
+    vector<vector<int>> kosarajuComponents(int vertices, const Adjacency &adj, const Adjacency &revAdj,
+                                           Counters &counters, SccInstrumentation *instrumentation)
+    {
+        V = vertices;
+        visited.assign(V, false);
+
+        // First pass: fill stack by finish time
+        for (int i = 0; i < V; ++i)
+        {
+            if (!visited[i])
+            {
+                dfsFillOrder(adj, i, counters);
+            }
+        }
+
+        if constexpr (Counters::enabled)
+        {
+            instrumentation->addEdgesScanned(counters.edges);
+            counters.edges = 0;
+            instrumentation->beginPhase("reverse_dfs");
+        }
+
+        visited.assign(V, false);
+        vector<vector<int>> components;
+
+        // Second pass: process nodes in reverse finish time order
+        while (!finishStack.empty())
+        {
+            int u = finishStack.top();
+            finishStack.pop();
+
+            if (!visited[u])
+            {
+                components.emplace_back();
+                dfsOnReversedGraph(revAdj, u, components.back(), counters);
+            }
+        }
+
+        if constexpr (Counters::enabled)
+        {
+            instrumentation->addEdgesScanned(counters.edges);
+            instrumentation->endPhase();
+        }
+
+        return components;
+    }
+
+    /**
+     * @brief Runs kosarajuComponents(), uninstrumented unless instrumentation is given.
+     *
+     * @param edges Edge count recorded in the instrumentation.
+     */
+    template <typename Adjacency>
+    vector<vector<int>> findKosarajuComponents(int vertices, uint64_t edges, const Adjacency &adj,
+                                               const Adjacency &revAdj, SccInstrumentation *instrumentation)
+    {
+        if (!instrumentation)
+        {
+            NoCounters counters;
+            return kosarajuComponents(vertices, adj, revAdj, counters, nullptr);
+        }
+
+        instrumentation->setGraph(vertices, edges);
+        instrumentation->beginPhase("first_dfs");
+        DfsCounters counters;
+        vector<vector<int>> components = kosarajuComponents(vertices, adj, revAdj, counters, instrumentation);
+        instrumentation->noteDfsDepth(counters.maxDepth);
+        instrumentation->addComponents(components);
+        return components;
+    }
+
+    /**
+     * @brief Prints the given SCCs using the node names of the graph.
+     *
+     * @param components The SCCs to print.
+     * @param directed_graph Graph or GraphSnapshot used to resolve node names.
+     * @return int The number of SCCs printed.
+     */
+    template <typename NamedGraph>
+    int printComponents(const vector<vector<int>> &components, const NamedGraph &directed_graph)
+    {
+        cout << "Strongly Connected Components (Kosaraju):\n";
+
+        for (size_t i = 0; i < components.size(); ++i)
+        {
+            cout << "SCC #" << i + 1 << ": ";
+            for (int u : components[i])
+            {
+                cout << directed_graph.getName(u) << " ";
             }
+            cout << endl;
         }
+
+        return components.size();
+    }
+
+    /**
+     * @brief Prints the components, timed as the "output" phase when instrumented.
+     */
+    template <typename NamedGraph>
+    int printComponents(const vector<vector<int>> &components, const NamedGraph &directed_graph,
+                        SccInstrumentation *instrumentation)
+    {
+        if (instrumentation)
+        {
+            instrumentation->beginPhase("output");
+        }
+        int count = printComponents(components, directed_graph);
+        if (instrumentation)
+        {
+            instrumentation->endPhase();
+        }
+        return count;
     }
 }
 
 /**
- * @brief Runs Kosaraju's Algorithm to find and print all strongly connected components (SCCs) in a directed graph.
+ * @brief Computes the strongly connected components (SCCs) of a directed graph without printing them.
  *
  * The algorithm works in two passes:
  * 1. Fills nodes in a stack according to their finishing times using DFS on the original graph.
  * 2. Performs DFS on the reversed graph in the order defined by the stack to identify SCCs.
  *
  * @param directed_graph Reference to the Graph object representing the directed graph.
- * @return int The number of strongly connected components found.
+ * @param instrumentation Optional; receives the phases, DFS depth and component sizes.
+ * @return vector<vector<int>> The SCCs in discovery order, each as a list of node IDs.
  */
-int KosarajuAlgorithm::run(Graph &directed_graph)
+vector<vector<int>> KosarajuAlgorithm::findComponents(const Graph &directed_graph, SccInstrumentation *instrumentation)
 {
-    V = directed_graph.getV();
-    visited.assign(V, false);
-
-    const vector<vector<int>> &adj = directed_graph.getAdj();
-    const vector<vector<int>> &revAdj = directed_graph.getRevAdj();
-
-    // First pass: fill stack by finish time
-    for (int i = 0; i < V; ++i)
+    uint64_t edges = 0;
+    if (instrumentation)
     {
-        if (!visited[i])
+        for (const vector<int> &neighbours : directed_graph.getAdj())
         {
-            dfsFillOrder(adj, i);
+            edges += neighbours.size();
         }
     }
+    return findKosarajuComponents(directed_graph.getV(), edges, directed_graph.getAdj(), directed_graph.getRevAdj(),
+                                  instrumentation);
+}
 
-    visited.assign(V, false);
-    int sccCount = 0;
-
-    cout << "Strongly Connected Components (Kosaraju):\n";
-
-    // Second pass: process nodes in reverse finish time order
-    while (!finishStack.empty())
-    {
-        int u = finishStack.top();
-        finishStack.pop();
+/**
+ * @brief Computes the strongly connected components (SCCs) of a memory-mapped graph snapshot.
+ *
+ * @param snapshot The snapshot to process.
+ * @param instrumentation Optional; receives the phases, DFS depth and component sizes.
+ * @return vector<vector<int>> The SCCs in discovery order, each as a list of node IDs.
+ */
+vector<vector<int>> KosarajuAlgorithm::findComponents(const GraphSnapshot &snapshot, SccInstrumentation *instrumentation)
+{
+    return findKosarajuComponents(snapshot.getV(), snapshot.getE(), snapshot.getAdj(), snapshot.getRevAdj(),
+                                  instrumentation);
+}
 
-        if (!visited[u])
-        {
-            cout << "SCC #" << sccCount + 1 << ": ";
-            dfsOnReversedGraph(revAdj, u, directed_graph);
-            cout << endl;
-            ++sccCount;
-        }
-    }
+/**
+ * @brief Runs Kosaraju's Algorithm to find and print all strongly connected components (SCCs) in a directed graph.
+ *
+ * Delegates the computation to findComponents() and prints each SCC using the node names.
+ *
+ * @param directed_graph Reference to the Graph object representing the directed graph.
+ * @param instrumentation Optional; also times printing as the "output" phase.
+ * @return int The number of strongly connected components found.
+ */
+int KosarajuAlgorithm::run(Graph &directed_graph, SccInstrumentation *instrumentation)
+{
+    return printComponents(findComponents(directed_graph, instrumentation), directed_graph, instrumentation);
+}
 
-    return sccCount;
+/**
+ * @brief Runs Kosaraju's Algorithm on a memory-mapped graph snapshot and prints its SCCs.
+ *
+ * @param snapshot The snapshot to process.
+ * @param instrumentation Optional; also times printing as the "output" phase.
+ * @return int The number of strongly connected components found.
+ */
+int KosarajuAlgorithm::run(const GraphSnapshot &snapshot, SccInstrumentation *instrumentation)
+{
+    return printComponents(findComponents(snapshot, instrumentation), snapshot, instrumentation);
 }
@@ -2,6 +2,8 @@
 #define STRONGLY_CONNECTED_H
 
 #include "directed_graph.h"
+#include "graph_snapshot.h"
+#include "scc_instrumentation.h"
 
 /**
  * @brief Implements Kosaraju's algorithm to find strongly connected components in a directed graph.
@@ -19,9 +21,44 @@ public:
      * This method finds and prints all strongly connected components (SCCs) in the graph.
      *
      * @param directed_graph The directed graph to process.
+     * @param instrumentation Optional; when given, records the DFS phases and the printing
+     *                        as "output". Without it the traversal does no counting at all.
      * @return int The number of strongly connected components found.
      */
-    static int run(Graph &directed_graph);
+    static int run(Graph &directed_graph, SccInstrumentation *instrumentation = nullptr);
+
+    /**
+     * @brief Computes the strongly connected components of the given directed graph.
+     *
+     * Unlike run(), nothing is printed; callers receive the components as node IDs
+     * and can resolve names through Graph::getName().
+     *
+     * @param directed_graph The directed graph to process.
+     * @param instrumentation Optional; receives the "first_dfs" and "reverse_dfs" phases with
+     *                        their edge scans, the deepest recursion and the component sizes.
+     * @return vector<vector<int>> The SCCs in discovery order, each as a list of node IDs.
+     */
+    static vector<vector<int>> findComponents(const Graph &directed_graph,
+                                              SccInstrumentation *instrumentation = nullptr);
+
+    /**
+     * @brief Runs Kosaraju's algorithm on a memory-mapped graph snapshot and prints its SCCs.
+     *
+     * @param snapshot The snapshot to process.
+     * @param instrumentation Optional, see run(Graph &, SccInstrumentation *).
+     * @return int The number of strongly connected components found.
+     */
+    static int run(const GraphSnapshot &snapshot, SccInstrumentation *instrumentation = nullptr);
+
+    /**
+     * @brief Computes the strongly connected components of a memory-mapped graph snapshot.
+     *
+     * @param snapshot The snapshot to process.
+     * @param instrumentation Optional, see findComponents(const Graph &, SccInstrumentation *).
+     * @return vector<vector<int>> The SCCs in discovery order, each as a list of node IDs.
+     */
+    static vector<vector<int>> findComponents(const GraphSnapshot &snapshot,
+                                              SccInstrumentation *instrumentation = nullptr);
 };
 
 #endif
\ No newline at end of file
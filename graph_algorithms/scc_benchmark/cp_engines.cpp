@@ -0,0 +1,42 @@
+// The CP template is a single self-contained file; compile it here without its driver.
+// Its definitions (SCCEngine, FastReader, print_sccs, ...) keep external linkage, so this
+// must remain the only translation unit of the benchmark that includes it.
+#define CP_TEMPLATE_NO_DRIVER
+#include "../scc_algo_cp_template/cp_template.cpp"
+
+#include "cp_engines.h"
+
+namespace
+{
+    // One engine reused across runs, as in a multi-testcase job.
+    SCCEngine engine;
+
+    vector<int> labels(int n)
+    {
+        return vector<int>(engine.comp.begin() + 1, engine.comp.begin() + 1 + n);
+    }
+}
+
+void CpEngines::load(const EdgeList &g)
+{
+    engine.init(g.n);
+    for (const auto &e : g.edges)
+    {
+        engine.add_edge(e.first + 1, e.second + 1);
+    }
+    engine.build();
+}
+
+vector<int> CpEngines::tarjan(int n)
+{
+    print_sccs = false;
+    engine.tarjan();
+    return labels(n);
+}
+
+vector<int> CpEngines::kosaraju(int n)
+{
+    print_sccs = false;
+    engine.kosaraju();
+    return labels(n);
+}
@@ -0,0 +1,38 @@
+#ifndef CP_ENGINES_H
+#define CP_ENGINES_H
+
+#include "graph_generators.h"
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Thin adapter that drives the engines of scc_algo_cp_template/cp_template.cpp.
+ *
+ * The CP template's SCCEngine works on 1-indexed vertices; this adapter loads an EdgeList
+ * into it and converts the resulting components back to 0-indexed per-vertex labels.
+ */
+class CpEngines
+{
+public:
+    /**
+     * @brief Resets the engine and loads the given edges into its CSR graphs.
+     */
+    static void load(const EdgeList &g);
+
+    /**
+     * @brief Runs Tarjan's algorithm on the loaded graph.
+     *
+     * @return vector<int> Component label of every vertex 0..n-1.
+     */
+    static vector<int> tarjan(int n);
+
+    /**
+     * @brief Runs Kosaraju's algorithm on the loaded graph.
+     *
+     * @return vector<int> Component label of every vertex 0..n-1.
+     */
+    static vector<int> kosaraju(int n);
+};
+
+#endif // CP_ENGINES_H
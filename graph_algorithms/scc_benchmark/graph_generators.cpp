@@ -0,0 +1,155 @@
+#include "graph_generators.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+EdgeList GraphGenerators::rmat(int scale, int edgeFactor, uint64_t seed,
+                               double a, double b, double c)
+{
+    EdgeList g;
+    g.n = 1 << scale;
+    long long m = (long long)edgeFactor * g.n;
+    g.edges.reserve(m);
+
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> coin(0.0, 1.0);
+
+    for (long long i = 0; i < m; ++i)
+    {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit)
+        {
+            double p = coin(rng);
+            if (p < a)
+            {
+                // top-left quadrant: neither bit set
+            }
+            else if (p < a + b)
+            {
+                v |= 1 << bit;
+            }
+            else if (p < a + b + c)
+            {
+                u |= 1 << bit;
+            }
+            else
+            {
+                u |= 1 << bit;
+                v |= 1 << bit;
+            }
+        }
+        g.edges.emplace_back(u, v);
+    }
+
+    // Scramble the IDs so that hubs are not clustered at small IDs.
+    vector<int> perm(g.n);
+    for (int i = 0; i < g.n; ++i)
+    {
+        perm[i] = i;
+    }
+    shuffle(perm.begin(), perm.end(), rng);
+    for (auto &e : g.edges)
+    {
+        e.first = perm[e.first];
+        e.second = perm[e.second];
+    }
+    return g;
+}
+
+EdgeList GraphGenerators::erdosRenyi(int n, long long m, uint64_t seed)
+{
+    EdgeList g;
+    g.n = n;
+    g.edges.reserve(m);
+
+    mt19937_64 rng(seed);
+    uniform_int_distribution<int> pick(0, n - 1);
+    for (long long i = 0; i < m; ++i)
+    {
+        g.edges.emplace_back(pick(rng), pick(rng));
+    }
+    return g;
+}
+
+EdgeList GraphGenerators::longChain(int n)
+{
+    EdgeList g;
+    g.n = n;
+    g.edges.reserve(n);
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        g.edges.emplace_back(i, i + 1);
+    }
+    return g;
+}
+
+EdgeList GraphGenerators::giantCycle(int n)
+{
+    EdgeList g = longChain(n);
+    if (n > 1)
+    {
+        g.edges.emplace_back(n - 1, 0);
+    }
+    return g;
+}
+
+EdgeList GraphGenerators::manySmallCycles(int n, int cycleLength)
+{
+    EdgeList g;
+    g.n = n;
+    g.edges.reserve((size_t)n + n / cycleLength);
+    for (int start = 0; start < n; start += cycleLength)
+    {
+        int end = min(n, start + cycleLength);
+        for (int i = start; i + 1 < end; ++i)
+        {
+            g.edges.emplace_back(i, i + 1);
+        }
+        if (end - start > 1)
+        {
+            g.edges.emplace_back(end - 1, start);
+        }
+        if (end < n)
+        {
+            g.edges.emplace_back(start, end); // link to the next cycle
+        }
+    }
+    return g;
+}
+
+EdgeList GraphGenerators::fromFile(const string &path, vector<string> &names)
+{
+    ifstream in(path);
+    if (!in)
+    {
+        throw runtime_error("cannot open " + path);
+    }
+
+    EdgeList g;
+    unordered_map<string, int> ids;
+    names.clear();
+
+    auto idOf = [&](const string &name)
+    {
+        auto it = ids.find(name);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        ids.emplace(name, (int)names.size());
+        names.push_back(name);
+        return (int)names.size() - 1;
+    };
+
+    string u, v;
+    while (in >> u >> v)
+    {
+        int a = idOf(u);
+        int b = idOf(v);
+        g.edges.emplace_back(a, b);
+    }
+    g.n = names.size();
+    return g;
+}
@@ -0,0 +1,81 @@
+#ifndef GRAPH_GENERATORS_H
+#define GRAPH_GENERATORS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief A directed graph stored as a plain edge list over vertices 0..n-1.
+ *
+ * This is the common input handed to every SCC engine by the benchmark, so that
+ * each engine pays for its own ingestion (name interning, adjacency building, ...).
+ */
+struct EdgeList
+{
+    /**
+     * @brief Number of vertices; every endpoint lies in [0, n).
+     */
+    int n = 0;
+
+    /**
+     * @brief Directed edges (source, destination).
+     */
+    vector<pair<int, int>> edges;
+};
+
+/**
+ * @brief Synthetic graph families used to stress the SCC engines.
+ *
+ * Each generator is deterministic for a given seed so that runs are comparable.
+ */
+class GraphGenerators
+{
+public:
+    /**
+     * @brief R-MAT / Kronecker graph with 2^scale vertices and edgeFactor * 2^scale edges.
+     *
+     * Each edge picks its quadrant recursively with probabilities (a, b, c, 1 - a - b - c),
+     * which yields the skewed degree distribution of real-world web and social graphs.
+     */
+    static EdgeList rmat(int scale, int edgeFactor, uint64_t seed,
+                         double a = 0.57, double b = 0.19, double c = 0.19);
+
+    /**
+     * @brief Erdős–Rényi G(n, m) graph with m edges drawn uniformly at random.
+     */
+    static EdgeList erdosRenyi(int n, long long m, uint64_t seed);
+
+    /**
+     * @brief Path 0 -> 1 -> ... -> n-1: n singleton SCCs and a DFS depth of n.
+     */
+    static EdgeList longChain(int n);
+
+    /**
+     * @brief Single cycle through all n vertices: one SCC and a DFS depth of n.
+     */
+    static EdgeList giantCycle(int n);
+
+    /**
+     * @brief Disjoint cycles of cycleLength vertices, each linked forward to the next one.
+     *
+     * Produces about n / cycleLength SCCs arranged as a DAG, which stresses the
+     * per-component bookkeeping rather than the traversal depth.
+     */
+    static EdgeList manySmallCycles(int n, int cycleLength);
+
+    /**
+     * @brief Reads a whitespace separated "source destination" edge list with string names.
+     *
+     * Names are mapped to dense IDs in first-seen order.
+     *
+     * @param path File to read.
+     * @param names Output vector receiving the name of every ID.
+     */
+    static EdgeList fromFile(const string &path, vector<string> &names);
+};
+
+#endif // GRAPH_GENERATORS_H
@@ -0,0 +1,64 @@
+#include "memory_tracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> highWater{0};
+
+    // Every block is prefixed with its size; 16 bytes keeps the payload max-aligned.
+    constexpr size_t HEADER = 16;
+
+    void *trackedAlloc(size_t size)
+    {
+        void *raw = std::malloc(size + HEADER);
+        if (raw == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        *static_cast<size_t *>(raw) = size;
+
+        size_t now = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = highWater.load(std::memory_order_relaxed);
+        while (now > peak && !highWater.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+        {
+        }
+        return static_cast<char *>(raw) + HEADER;
+    }
+
+    void trackedFree(void *ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        void *raw = static_cast<char *>(ptr) - HEADER;
+        liveBytes.fetch_sub(*static_cast<size_t *>(raw), std::memory_order_relaxed);
+        std::free(raw);
+    }
+}
+
+void *operator new(size_t size) { return trackedAlloc(size); }
+void *operator new[](size_t size) { return trackedAlloc(size); }
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { trackedFree(ptr); }
+
+size_t MemoryTracker::currentBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::peakBytes()
+{
+    return highWater.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::resetPeak()
+{
+    highWater.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
@@ -0,0 +1,32 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <cstddef>
+
+/**
+ * @brief Tracks live and peak heap usage by replacing the global operator new/delete.
+ *
+ * Linking memory_tracker.cpp into a program is enough to enable tracking. The peak
+ * can be reset between phases so that each engine is charged only for its own data.
+ * The peak RSS of the whole process comes from SccInstrumentation::peakRssBytes().
+ */
+class MemoryTracker
+{
+public:
+    /**
+     * @brief Returns the number of heap bytes currently allocated through operator new.
+     */
+    static size_t currentBytes();
+
+    /**
+     * @brief Returns the highest value of currentBytes() since the last resetPeak().
+     */
+    static size_t peakBytes();
+
+    /**
+     * @brief Restarts peak tracking from the current live heap size.
+     */
+    static void resetPeak();
+};
+
+#endif // MEMORY_TRACKER_H
@@ -0,0 +1,435 @@
+#include "graph_generators.h"
+#include "cp_engines.h"
+#include "memory_tracker.h"
+#include "../scc_algo_dev_template/directed_graph.h"
+#include "../scc_algo_dev_template/strongly_connected.h"
+#include "../scc_algo_dev_template/graph_reordering.h"
+#include "../scc_algo_dev_template/graph_snapshot.h"
+#include "../scc_algo_dev_template/scc_instrumentation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    typedef chrono::steady_clock Clock;
+
+    /**
+     * @brief Benchmark settings parsed from the command line.
+     */
+    struct Options
+    {
+        string generator = "all";
+        string input;
+        string reorder;
+        int vertices = 1 << 16;
+        int edgeFactor = 8;
+        int cycleLength = 4;
+        int repeat = 1;
+        uint64_t seed = 42;
+    };
+
+    /**
+     * @brief Measurements of a single engine run.
+     */
+    struct EngineResult
+    {
+        string engine;
+        double ingestMs = 0;
+        double solveMs = 0;
+        size_t peakHeap = 0;
+        vector<int> label;
+    };
+
+    double msSince(Clock::time_point start)
+    {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Rewrites component labels so that each vertex is labelled with the smallest
+     *        vertex of its component, making partitions from different engines comparable.
+     */
+    vector<int> canonicalize(const vector<int> &label)
+    {
+        int maxLabel = 0;
+        for (int l : label)
+        {
+            maxLabel = max(maxLabel, l);
+        }
+        vector<int> smallest(maxLabel + 1, -1);
+        for (int v = 0; v < (int)label.size(); ++v)
+        {
+            if (smallest[label[v]] == -1)
+            {
+                smallest[label[v]] = v;
+            }
+        }
+        vector<int> canonical(label.size());
+        for (int v = 0; v < (int)label.size(); ++v)
+        {
+            canonical[v] = smallest[label[v]];
+        }
+        return canonical;
+    }
+
+    int countComponents(const vector<int> &canonical)
+    {
+        int count = 0;
+        for (int v = 0; v < (int)canonical.size(); ++v)
+        {
+            count += canonical[v] == v;
+        }
+        return count;
+    }
+
+    EngineResult runDevKosaraju(const EdgeList &g)
+    {
+        EngineResult r;
+        r.engine = "dev-kosaraju";
+        MemoryTracker::resetPeak();
+        size_t base = MemoryTracker::currentBytes();
+
+        auto start = Clock::now();
+        Graph graph(0);
+        for (const auto &e : g.edges)
+        {
+            graph.addEdge(to_string(e.first), to_string(e.second));
+        }
+        r.ingestMs = msSince(start);
+
+        start = Clock::now();
+        vector<vector<int>> components = KosarajuAlgorithm::findComponents(graph);
+        r.solveMs = msSince(start);
+        r.peakHeap = MemoryTracker::peakBytes() - base;
+
+        // Vertices without edges never reach the Graph; they are singleton SCCs.
+        r.label.resize(g.n);
+        for (int v = 0; v < g.n; ++v)
+        {
+            r.label[v] = v;
+        }
+        for (const auto &component : components)
+        {
+            int id = stoi(graph.getName(component[0]));
+            for (int u : component)
+            {
+                r.label[stoi(graph.getName(u))] = id;
+            }
+        }
+        return r;
+    }
+
+    /**
+     * @brief Dev-template Kosaraju on a memory-mapped snapshot; ingestion is the time to open it.
+     */
+    EngineResult runDevSnapshot(const EdgeList &g)
+    {
+        EngineResult r;
+        r.engine = "dev-snapshot";
+        string path = (filesystem::temp_directory_path() / "scc_benchmark.snap").string();
+        {
+            Graph graph(0);
+            for (const auto &e : g.edges)
+            {
+                graph.addEdge(to_string(e.first), to_string(e.second));
+            }
+            GraphSnapshot::save(graph, path);
+        }
+        MemoryTracker::resetPeak();
+        size_t base = MemoryTracker::currentBytes();
+
+        auto start = Clock::now();
+        GraphSnapshot snapshot(path);
+        r.ingestMs = msSince(start);
+
+        start = Clock::now();
+        vector<vector<int>> components = KosarajuAlgorithm::findComponents(snapshot);
+        r.solveMs = msSince(start);
+        r.peakHeap = MemoryTracker::peakBytes() - base;
+
+        r.label.resize(g.n);
+        for (int v = 0; v < g.n; ++v)
+        {
+            r.label[v] = v;
+        }
+        for (const auto &component : components)
+        {
+            int id = stoi(string(snapshot.getName(component[0])));
+            for (int u : component)
+            {
+                r.label[stoi(string(snapshot.getName(u)))] = id;
+            }
+        }
+        remove(path.c_str());
+        return r;
+    }
+
+    EngineResult runCp(const EdgeList &g, bool useTarjan)
+    {
+        EngineResult r;
+        r.engine = useTarjan ? "cp-tarjan" : "cp-kosaraju";
+        MemoryTracker::resetPeak();
+        size_t base = MemoryTracker::currentBytes();
+
+        auto start = Clock::now();
+        CpEngines::load(g);
+        r.ingestMs = msSince(start);
+
+        start = Clock::now();
+        r.label = useTarjan ? CpEngines::tarjan(g.n) : CpEngines::kosaraju(g.n);
+        r.solveMs = msSince(start);
+        r.peakHeap = MemoryTracker::peakBytes() - base;
+        return r;
+    }
+
+    /**
+     * @brief Times KosarajuAlgorithm::findComponents() on a graph, keeping the best of opt.repeat runs.
+     */
+    double timeDevSolve(const Graph &graph, const Options &opt, vector<vector<int>> &components)
+    {
+        double best = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto start = Clock::now();
+            components = KosarajuAlgorithm::findComponents(graph);
+            double ms = msSince(start);
+            best = rep == 0 ? ms : min(best, ms);
+        }
+        return best;
+    }
+
+    /**
+     * @brief Measures how much each vertex reordering speeds up the dev-template Kosaraju.
+     *
+     * The graph is ingested in first-seen order (as the interactive tool does), then relabelled
+     * with every requested strategy. Partitions are mapped back to the original IDs and checked.
+     */
+    void reorderStudy(const string &name, const EdgeList &g, const vector<string> &names, const Options &opt)
+    {
+        Graph graph(0);
+        for (const auto &e : g.edges)
+        {
+            graph.addEdge(names.empty() ? to_string(e.first) : names[e.first],
+                          names.empty() ? to_string(e.second) : names[e.second]);
+        }
+
+        vector<vector<int>> components;
+        double baseline = timeDevSolve(graph, opt, components);
+        vector<int> label(graph.getV());
+        for (size_t c = 0; c < components.size(); ++c)
+        {
+            for (int u : components[c])
+            {
+                label[u] = c;
+            }
+        }
+        vector<int> reference = canonicalize(label);
+
+        printf("\n== %s: reordering study, V=%d E=%zu\n", name.c_str(), graph.getV(), g.edges.size());
+        printf("%-12s %12s %10s %10s %s\n", "order", "reorder ms", "solve ms", "speedup", "partition");
+        printf("%-12s %12s %10.2f %10.2f %s\n", "first-seen", "-", baseline, 1.0, "reference");
+
+        vector<string> strategies;
+        if (opt.reorder == "all")
+            strategies = {"bfs", "rcm", "degree"};
+        else
+            strategies = {opt.reorder};
+
+        for (const string &strategyName : strategies)
+        {
+            ReorderStrategy strategy;
+            if (!GraphReordering::parseStrategy(strategyName, strategy))
+            {
+                fprintf(stderr, "unknown reordering strategy %s\n", strategyName.c_str());
+                exit(1);
+            }
+            auto start = Clock::now();
+            vector<int> newToOld = GraphReordering::computeOrder(graph, strategy);
+            Graph reordered = GraphReordering::apply(graph, newToOld);
+            double reorderMs = msSince(start);
+
+            double solveMs = timeDevSolve(reordered, opt, components);
+            for (size_t c = 0; c < components.size(); ++c)
+            {
+                for (int u : components[c])
+                {
+                    label[newToOld[u]] = c;
+                }
+            }
+            bool same = canonicalize(label) == reference;
+            printf("%-12s %12.2f %10.2f %10.2f %s\n", strategyName.c_str(), reorderMs, solveMs,
+                   baseline / solveMs, same ? "identical" : "MISMATCH");
+            if (!same)
+            {
+                fprintf(stderr, "partition mismatch after %s reordering on %s\n", strategyName.c_str(), name.c_str());
+                exit(1);
+            }
+        }
+    }
+
+    void benchmark(const string &name, const EdgeList &g, double generateMs, const Options &opt)
+    {
+        printf("\n== %s: V=%d E=%zu (generated in %.1f ms)\n", name.c_str(), g.n, g.edges.size(), generateMs);
+        printf("%-14s %10s %10s %10s %12s %12s %10s %s\n",
+               "engine", "ingest ms", "solve ms", "total ms", "Medges/s", "peak heap MB", "SCCs", "partition");
+
+        vector<int> reference;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            vector<EngineResult> results;
+            results.push_back(runDevKosaraju(g));
+            results.push_back(runDevSnapshot(g));
+            results.push_back(runCp(g, true));
+            results.push_back(runCp(g, false));
+
+            for (EngineResult &r : results)
+            {
+                vector<int> canonical = canonicalize(r.label);
+                const char *verdict = "reference";
+                if (reference.empty())
+                {
+                    reference = canonical;
+                }
+                else
+                {
+                    verdict = canonical == reference ? "identical" : "MISMATCH";
+                }
+                double total = r.ingestMs + r.solveMs;
+                printf("%-14s %10.2f %10.2f %10.2f %12.2f %12.2f %10d %s\n",
+                       r.engine.c_str(), r.ingestMs, r.solveMs, total,
+                       g.edges.size() / (total * 1e3), r.peakHeap / 1048576.0,
+                       countComponents(canonical), verdict);
+                if (canonical != reference)
+                {
+                    fprintf(stderr, "partition mismatch for %s on %s\n", r.engine.c_str(), name.c_str());
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    void runAll(const Options &opt)
+    {
+        vector<string> names;
+        auto timed = [&](const string &name, const function<EdgeList()> &make)
+        {
+            if (opt.generator != "all" && opt.generator != name)
+            {
+                return;
+            }
+            auto start = Clock::now();
+            EdgeList g = make();
+            if (opt.reorder.empty())
+                benchmark(name, g, msSince(start), opt);
+            else
+                reorderStudy(name, g, names, opt);
+        };
+
+        if (!opt.input.empty())
+        {
+            timed("file", [&]
+                  { return GraphGenerators::fromFile(opt.input, names); });
+            return;
+        }
+
+        int scale = 0;
+        while ((1 << (scale + 1)) <= opt.vertices)
+        {
+            ++scale;
+        }
+        timed("rmat", [&]
+              { return GraphGenerators::rmat(scale, opt.edgeFactor, opt.seed); });
+        timed("erdos-renyi", [&]
+              { return GraphGenerators::erdosRenyi(opt.vertices, (long long)opt.edgeFactor * opt.vertices, opt.seed); });
+        timed("long-chain", [&]
+              { return GraphGenerators::longChain(opt.vertices); });
+        timed("giant-cycle", [&]
+              { return GraphGenerators::giantCycle(opt.vertices); });
+        timed("small-cycles", [&]
+              { return GraphGenerators::manySmallCycles(opt.vertices, opt.cycleLength); });
+    }
+
+    /**
+     * @brief Runs the benchmark on a thread with a large stack.
+     *
+     * The dev-template engines use recursive DFS, so long chains and giant cycles recurse once per vertex.
+     */
+    void *benchmarkThread(void *arg)
+    {
+        runAll(*static_cast<Options *>(arg));
+        return nullptr;
+    }
+
+    void usage(const char *prog)
+    {
+        fprintf(stderr,
+                "Usage: %s [--generator all|rmat|erdos-renyi|long-chain|giant-cycle|small-cycles]\n"
+                "          [--vertices N] [--edge-factor F] [--cycle-length K] [--seed S]\n"
+                "          [--repeat R] [--input edges.txt] [--reorder all|bfs|rcm|degree]\n",
+                prog);
+        exit(1);
+    }
+}
+
+/**
+ * @brief Benchmarks the dev-template Kosaraju and the CP-template Tarjan and Kosaraju engines
+ *        on synthetic or file-based graphs, checking that all of them agree on the partition.
+ *
+ * With --reorder, measures instead the speedup that vertex reordering gives the dev-template
+ * Kosaraju.
+ */
+int main(int argc, char **argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage(argv[0]);
+        }
+        string value = argv[++i];
+        if (arg == "--generator")
+            opt.generator = value;
+        else if (arg == "--vertices")
+            opt.vertices = stoi(value);
+        else if (arg == "--edge-factor")
+            opt.edgeFactor = stoi(value);
+        else if (arg == "--cycle-length")
+            opt.cycleLength = max(1, stoi(value));
+        else if (arg == "--seed")
+            opt.seed = stoull(value);
+        else if (arg == "--repeat")
+            opt.repeat = max(1, stoi(value));
+        else if (arg == "--input")
+            opt.input = value;
+        else if (arg == "--reorder")
+            opt.reorder = value;
+        else
+            usage(argv[0]);
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, (size_t)1 << 30);
+    pthread_t worker;
+    if (pthread_create(&worker, &attr, benchmarkThread, &opt) != 0)
+    {
+        perror("pthread_create");
+        return 1;
+    }
+    pthread_join(worker, nullptr);
+    pthread_attr_destroy(&attr);
+
+    printf("\nPeak process RSS: %.2f MB\n", SccInstrumentation::peakRssBytes() / 1048576.0);
+    return 0;
+}
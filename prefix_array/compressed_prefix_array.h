@@ -0,0 +1,281 @@
+#ifndef COMPRESSED_PREFIX_ARRAY_H
+#define COMPRESSED_PREFIX_ARRAY_H
+
+#include "prefix_array.h"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Range sum and range xor queries in O(1) over a compressed copy of the prefix arrays.
+ *
+ * The N + 1 prefix positions are cut into blocks of BLOCK. Each block keeps full sum and xor
+ * values at its start; every position stores only its offset from them, bit-packed at the
+ * smallest width that holds the largest offset of the block:
+ *   - sum:  p - m, where m is the smallest in-block prefix (frame of reference),
+ *   - xor:  the in-block xor prefix in T's width, zigzag-coded so that small negative values
+ *           stay narrow too (sign extension commutes with xor, so T's width suffices).
+ * Smooth data such as time series compresses to a few bits per value; random data falls
+ * back to about the width of T.
+ *
+ * A prefix lookup reads one block header and one field with at most two 64-bit loads, so
+ * a query costs two lookups per aggregate whatever the widths. Construction runs
+ * prefix_scan() over chunks of the input and never materialises the full prefix arrays.
+ *
+ * @tparam T Element type (integral).
+ * @tparam Acc Accumulator type (integral, at most 64 bits).
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class CompressedPrefixArray
+{
+    static_assert(is_integral<T>::value && is_integral<Acc>::value && sizeof(Acc) <= 8,
+                  "CompressedPrefixArray needs integral elements and accumulators of at most 64 bits");
+
+public:
+    static constexpr size_t BLOCK = 64;
+
+private:
+    typedef typename make_unsigned<Acc>::type UAcc;
+    typedef typename make_unsigned<T>::type UT;
+    typedef typename make_signed<T>::type ST;
+
+    struct Block
+    {
+        Acc sum_base;
+        Acc xor_base;
+        uint64_t bit_offset; // sum fields, followed by the xor fields
+        uint8_t sum_width;
+        uint8_t xor_width;
+    };
+
+    long long N;
+    vector<Block> blocks;
+    vector<uint64_t> bits;
+
+    static unsigned _width(uint64_t value)
+    {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    static uint64_t _zigzag(UT x)
+    {
+        return UT(x << 1) ^ UT(ST(x) >> (8 * sizeof(T) - 1));
+    }
+
+    static UT _unzigzag(uint64_t z)
+    {
+        return UT(z >> 1) ^ UT(0 - UT(z & 1));
+    }
+
+    /**
+     * @brief Reads the width-bit field at bit position; branch-free, since widths vary from
+     *        block to block and random queries would mispredict every branch on them.
+     */
+    uint64_t _field(uint64_t position, unsigned width) const
+    {
+        const uint64_t *word = this->bits.data() + (position >> 6);
+        unsigned shift = position & 63;
+        uint64_t value = (word[0] >> shift) | ((word[1] << 1) << (63 - shift));
+        uint64_t mask = ((uint64_t(1) << (width & 63)) - 1) | (0 - uint64_t(width >> 6));
+        return value & mask;
+    }
+
+    void _put(uint64_t position, unsigned width, uint64_t value)
+    {
+        if (width == 0)
+        {
+            return;
+        }
+        uint64_t *word = this->bits.data() + (position >> 6);
+        unsigned shift = position & 63;
+        word[0] |= value << shift;
+        if (shift + width > 64)
+        {
+            word[1] |= value >> (64 - shift);
+        }
+    }
+
+    /**
+     * @brief Packs one block whose sum and xor prefixes are sums[0..count) and xors[0..count).
+     */
+    void _pack(const Acc *sums, const Acc *xors, size_t count)
+    {
+        Acc low = 0;
+        uint64_t sum_span = 0, xor_span = 0;
+        for (size_t j = 0; j < count; j++)
+        {
+            low = min(low, Acc(UAcc(sums[j]) - UAcc(sums[0])));
+        }
+        for (size_t j = 0; j < count; j++)
+        {
+            sum_span |= uint64_t(UAcc(UAcc(sums[j]) - UAcc(sums[0]) - UAcc(low)));
+            xor_span |= _zigzag(UT(xors[j] ^ xors[0]));
+        }
+
+        Block block;
+        block.sum_base = Acc(UAcc(sums[0]) + UAcc(low));
+        block.xor_base = xors[0];
+        block.bit_offset = this->blocks.empty() ? 0
+                                                : this->blocks.back().bit_offset +
+                                                      BLOCK * (this->blocks.back().sum_width + this->blocks.back().xor_width);
+        block.sum_width = _width(sum_span);
+        block.xor_width = _width(xor_span);
+        this->blocks.push_back(block);
+
+        uint64_t end = block.bit_offset + BLOCK * (block.sum_width + block.xor_width);
+        this->bits.resize(end / 64 + 2, 0);
+        uint64_t sum_bits = block.bit_offset, xor_bits = block.bit_offset + BLOCK * block.sum_width;
+        for (size_t j = 0; j < count; j++)
+        {
+            this->_put(sum_bits + j * block.sum_width, block.sum_width,
+                       uint64_t(UAcc(UAcc(sums[j]) - UAcc(block.sum_base))));
+            this->_put(xor_bits + j * block.xor_width, block.xor_width, _zigzag(UT(xors[j] ^ xors[0])));
+        }
+    }
+
+    /**
+     * @brief Sum and xor of arr[0..i - 1], reading the block header once.
+     */
+    RangeAggregates<Acc> _prefixes(long long i) const
+    {
+        const Block &block = this->blocks[i / BLOCK];
+        uint64_t sum_position = block.bit_offset + (i % BLOCK) * block.sum_width;
+        uint64_t xor_position = block.bit_offset + BLOCK * block.sum_width + (i % BLOCK) * block.xor_width;
+        uint64_t sum_offset = this->_field(sum_position, block.sum_width);
+        uint64_t xor_offset = this->_field(xor_position, block.xor_width);
+        return {Acc(UAcc(block.sum_base) + UAcc(sum_offset)), block.xor_base ^ Acc(T(_unzigzag(xor_offset)))};
+    }
+
+public:
+    /**
+     * @param kernel Scan kernel used while building, see prefix_scan().
+     */
+    explicit CompressedPrefixArray(const vector<T> &arr, ScanKernel kernel = ScanKernel::Auto)
+        : N(arr.size())
+    {
+        const size_t positions = arr.size() + 1;
+        const size_t chunk = BLOCK * 1024;
+        vector<Acc> sums(chunk), xors(chunk);
+        Acc sum_carry = SumOp<Acc>::identity(), xor_carry = XorOp<Acc>::identity();
+        this->blocks.reserve((positions + BLOCK - 1) / BLOCK);
+
+        // Position p holds the prefix of arr[0..p - 1], so position 0 is the identity and
+        // every later position scans the element before it.
+        for (size_t start = 0; start < positions; start += chunk)
+        {
+            size_t count = min(chunk, positions - start);
+            size_t skip = start == 0 ? 1 : 0;
+            sums[0] = sum_carry;
+            xors[0] = xor_carry;
+            const T *in = arr.data() + start + skip - 1;
+            sum_carry = prefix_scan<T, Acc, SumOp<Acc>>(in, sums.data() + skip, count - skip, sum_carry, kernel);
+            xor_carry = prefix_scan<T, Acc, XorOp<Acc>>(in, xors.data() + skip, count - skip, xor_carry, kernel);
+            for (size_t j = 0; j < count; j += BLOCK)
+            {
+                this->_pack(sums.data() + j, xors.data() + j, min(BLOCK, count - j));
+            }
+        }
+        this->bits.shrink_to_fit();
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    /**
+     * @brief Sum of arr[0..i - 1].
+     */
+    Acc prefix_sum(long long i) const
+    {
+        const Block &block = this->blocks[i / BLOCK];
+        uint64_t offset = this->_field(block.bit_offset + (i % BLOCK) * block.sum_width, block.sum_width);
+        return Acc(UAcc(block.sum_base) + UAcc(offset));
+    }
+
+    /**
+     * @brief Xor of arr[0..i - 1].
+     */
+    Acc prefix_xor(long long i) const
+    {
+        const Block &block = this->blocks[i / BLOCK];
+        uint64_t position = block.bit_offset + BLOCK * block.sum_width + (i % BLOCK) * block.xor_width;
+        return block.xor_base ^ Acc(T(_unzigzag(this->_field(position, block.xor_width))));
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->N))
+        {
+            return invalid_query();
+        }
+        return SumOp<Acc>::subtract(this->prefix_sum(r + 1), this->prefix_sum(l));
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->N))
+        {
+            return invalid_query();
+        }
+        return XorOp<Acc>::subtract(this->prefix_xor(r + 1), this->prefix_xor(l));
+    }
+
+    /**
+     * @brief Answers a batch of queries, see PrefixArray::range_queries().
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, RangeAggregates<Acc> *results,
+                         bool sort_queries = false) const
+    {
+        return answer_range_queries(this->N, queries, count, results, {invalid_query(), invalid_query()},
+                                    sort_queries, [this](long long l, long long r) -> RangeAggregates<Acc>
+                                    {
+                                        RangeAggregates<Acc> high = this->_prefixes(r + 1), low = this->_prefixes(l);
+                                        return {SumOp<Acc>::subtract(high.sum, low.sum),
+                                                XorOp<Acc>::subtract(high.xor_value, low.xor_value)};
+                                    });
+    }
+
+    /**
+     * @brief Bytes held by the block headers and the packed fields.
+     */
+    size_t memory_bytes() const
+    {
+        return this->blocks.capacity() * sizeof(Block) + this->bits.capacity() * sizeof(uint64_t);
+    }
+
+    /**
+     * @brief Bytes PrefixArray needs for the same array: two full prefix arrays.
+     */
+    size_t uncompressed_bytes() const
+    {
+        return 2 * (this->N + 1) * sizeof(Acc);
+    }
+
+    double compression_ratio() const
+    {
+        return (double)this->uncompressed_bytes() / this->memory_bytes();
+    }
+
+    /**
+     * @brief Average packed bits per prefix position: the sum field plus the xor field, headers
+     *        excluded. Random 32-bit data needs about 33 + 33 bits, twice a single prefix width.
+     */
+    double bits_per_value() const
+    {
+        uint64_t used = this->blocks.empty() ? 0
+                                             : this->blocks.back().bit_offset +
+                                                   BLOCK * (this->blocks.back().sum_width + this->blocks.back().xor_width);
+        return (double)used / (this->N + 1);
+    }
+};
+
+#endif // COMPRESSED_PREFIX_ARRAY_H
@@ -0,0 +1,199 @@
+#ifndef FAST_IO_H
+#define FAST_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Buffered reader for whitespace separated integers or raw binary values.
+ *
+ * Reads the underlying FILE* in large blocks with fread, so parsing costs a few instructions
+ * per digit instead of an iostream call per value.
+ */
+class FastReader
+{
+private:
+    FILE *in;
+    vector<char> buffer;
+    size_t length;
+    size_t position;
+
+    bool _refill()
+    {
+        this->length = fread(this->buffer.data(), 1, this->buffer.size(), this->in);
+        this->position = 0;
+        return this->length > 0;
+    }
+
+    int _peek()
+    {
+        if (this->position == this->length && !this->_refill())
+        {
+            return EOF;
+        }
+        return (unsigned char)this->buffer[this->position];
+    }
+
+public:
+    explicit FastReader(FILE *in = stdin, size_t buffer_bytes = 1 << 16)
+        : in(in), buffer(buffer_bytes), length(0), position(0)
+    {
+    }
+
+    /**
+     * @brief Parses the next (optionally negative) decimal integer.
+     *
+     * @return bool False at end of input.
+     */
+    template <typename Int>
+    bool read(Int &value)
+    {
+        int c = this->_peek();
+        while (c != EOF && c != '-' && (c < '0' || c > '9'))
+        {
+            this->position++;
+            c = this->_peek();
+        }
+        if (c == EOF)
+        {
+            return false;
+        }
+        bool negative = c == '-';
+        if (negative)
+        {
+            this->position++;
+            c = this->_peek();
+        }
+        typename make_unsigned<Int>::type magnitude = 0;
+        while (c >= '0' && c <= '9')
+        {
+            magnitude = magnitude * 10 + (c - '0');
+            this->position++;
+            c = this->_peek();
+        }
+        value = negative ? Int(0 - magnitude) : Int(magnitude);
+        return true;
+    }
+
+    /**
+     * @brief Copies the next count raw values of type T from the input.
+     *
+     * @return size_t Number of values actually read.
+     */
+    template <typename T>
+    size_t read_binary(T *values, size_t count)
+    {
+        char *out = reinterpret_cast<char *>(values);
+        size_t wanted = count * sizeof(T), got = 0;
+        while (got < wanted)
+        {
+            if (this->position == this->length && !this->_refill())
+            {
+                break;
+            }
+            size_t chunk = min(wanted - got, this->length - this->position);
+            memcpy(out + got, this->buffer.data() + this->position, chunk);
+            this->position += chunk;
+            got += chunk;
+        }
+        return got / sizeof(T);
+    }
+};
+
+/**
+ * @brief Buffered writer for decimal integers or raw binary values; flushes when the buffer
+ *        fills, on flush() and on destruction, never per line.
+ */
+class FastWriter
+{
+private:
+    FILE *out;
+    vector<char> buffer;
+    size_t length;
+
+public:
+    explicit FastWriter(FILE *out = stdout, size_t buffer_bytes = 1 << 16)
+        : out(out), buffer(buffer_bytes), length(0)
+    {
+    }
+
+    ~FastWriter()
+    {
+        this->flush();
+    }
+
+    void flush()
+    {
+        fwrite(this->buffer.data(), 1, this->length, this->out);
+        this->length = 0;
+        fflush(this->out);
+    }
+
+    void write_char(char c)
+    {
+        if (this->length == this->buffer.size())
+        {
+            this->flush();
+        }
+        this->buffer[this->length++] = c;
+    }
+
+    /**
+     * @brief Writes value in decimal.
+     */
+    template <typename Int>
+    void write(Int value)
+    {
+        if (this->length + 24 > this->buffer.size())
+        {
+            this->flush();
+        }
+        typename make_unsigned<Int>::type magnitude = value;
+        if (value < 0)
+        {
+            this->buffer[this->length++] = '-';
+            magnitude = 0 - magnitude;
+        }
+        char digits[24];
+        int count = 0;
+        do
+        {
+            digits[count++] = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude > 0);
+        while (count > 0)
+        {
+            this->buffer[this->length++] = digits[--count];
+        }
+    }
+
+    /**
+     * @brief Writes count raw values of type T.
+     */
+    template <typename T>
+    void write_binary(const T *values, size_t count)
+    {
+        const char *data = reinterpret_cast<const char *>(values);
+        size_t bytes = count * sizeof(T);
+        while (bytes > 0)
+        {
+            if (this->length == this->buffer.size())
+            {
+                this->flush();
+            }
+            size_t chunk = min(bytes, this->buffer.size() - this->length);
+            memcpy(this->buffer.data() + this->length, data, chunk);
+            this->length += chunk;
+            data += chunk;
+            bytes -= chunk;
+        }
+    }
+};
+
+#endif // FAST_IO_H
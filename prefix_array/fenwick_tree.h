@@ -0,0 +1,182 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include "prefix_ops.h"
+#include "range_query.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Fenwick (binary indexed) tree: O(log n) point updates and range queries.
+ *
+ * Needs a commutative operator with subtract() (sum, xor, ...). tree[i] (1-based) holds the
+ * combination of the lowbit(i) elements ending at position i - 1.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ * @tparam Op Commutative invertible operator, see prefix_ops.h.
+ */
+template <typename T, typename Acc = wide_accumulator_t<T>, typename Op = SumOp<Acc>>
+class FenwickTree
+{
+private:
+    long long N;
+    vector<Acc> tree;
+
+    static size_t lowbit(size_t i)
+    {
+        return i & (~i + 1);
+    }
+
+    /**
+     * @brief O(n) construction: every node pushes its value to its parent once.
+     */
+    void _build()
+    {
+        for (size_t i = 1; i <= (size_t)this->N; i++)
+        {
+            size_t parent = i + lowbit(i);
+            if (parent <= (size_t)this->N)
+            {
+                this->tree[parent] = Op::combine(this->tree[parent], this->tree[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Inverse of _build(): turns the tree back into the plain element values in O(n).
+     */
+    void _unbuild()
+    {
+        for (size_t i = this->N; i >= 1; i--)
+        {
+            size_t parent = i + lowbit(i);
+            if (parent <= (size_t)this->N)
+            {
+                this->tree[parent] = Op::subtract(this->tree[parent], this->tree[i]);
+            }
+        }
+    }
+
+public:
+    explicit FenwickTree(const vector<T> &arr) : N(arr.size()), tree(arr.size() + 1, Op::identity())
+    {
+        for (size_t i = 0; i < arr.size(); i++)
+        {
+            this->tree[i + 1] = Acc(arr[i]);
+        }
+        this->_build();
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    bool valid_range(long long l, long long r) const
+    {
+        return ::valid_range(l, r, this->N);
+    }
+
+    /**
+     * @brief Combination of the first count elements.
+     */
+    Acc prefix(long long count) const
+    {
+        Acc result = Op::identity();
+        for (size_t i = count; i > 0; i -= lowbit(i))
+        {
+            result = Op::combine(result, this->tree[i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Combination of arr[l..r], or invalid_query() if the range is out of bounds.
+     */
+    Acc query(long long l, long long r) const
+    {
+        if (!this->valid_range(l, r))
+        {
+            return invalid_query();
+        }
+        return Op::subtract(this->prefix(r + 1), this->prefix(l));
+    }
+
+    /**
+     * @brief Combines delta into arr[i].
+     *
+     * @return bool False if i is out of bounds.
+     */
+    bool add(long long i, const Acc &delta)
+    {
+        if (i < 0 || i >= this->N)
+        {
+            return false;
+        }
+        for (size_t j = i + 1; j <= (size_t)this->N; j += lowbit(j))
+        {
+            this->tree[j] = Op::combine(this->tree[j], delta);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sets arr[i] to value.
+     *
+     * @return bool False if i is out of bounds.
+     */
+    bool update(long long i, const T &value)
+    {
+        if (i < 0 || i >= this->N)
+        {
+            return false;
+        }
+        return this->add(i, Op::subtract(Acc(value), this->query(i, i)));
+    }
+
+    /**
+     * @brief Applies a batch of (index, value) assignments; later entries win.
+     *
+     * Small batches are applied one by one in O(k log n). Once k log n exceeds n, the tree is
+     * unbuilt to plain values, assigned and rebuilt in O(n + k) instead.
+     *
+     * @return size_t Number of in-bounds assignments applied.
+     */
+    size_t update_batch(const vector<pair<long long, T>> &updates)
+    {
+        size_t applied = 0;
+        if ((double)updates.size() * log2((double)this->N + 2) < (double)this->N)
+        {
+            for (const auto &u : updates)
+            {
+                applied += this->update(u.first, u.second);
+            }
+            return applied;
+        }
+
+        this->_unbuild();
+        for (const auto &u : updates)
+        {
+            if (u.first >= 0 && u.first < this->N)
+            {
+                this->tree[u.first + 1] = Acc(u.second);
+                applied++;
+            }
+        }
+        this->_build();
+        return applied;
+    }
+};
+
+#endif // FENWICK_TREE_H
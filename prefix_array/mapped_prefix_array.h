@@ -0,0 +1,350 @@
+#ifndef MAPPED_PREFIX_ARRAY_H
+#define MAPPED_PREFIX_ARRAY_H
+
+#include "prefix_array.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief On-disk prefix index for arrays larger than memory.
+ *
+ * MappedPrefixWriter streams the input in chunks and appends prefix values to an index file,
+ * so building needs O(chunk) memory whatever the array size. MappedPrefixArray maps the index
+ * read-only: queries read the page cache directly, processes querying the same index share
+ * one copy of it, and opening an index costs no rebuild.
+ *
+ * File layout, native byte order:
+ *   MappedPrefixHeader                   64 bytes
+ *   RangeAggregates<Acc>[elements + 1]   entry i holds the sum and the xor of arr[0..i - 1]
+ *
+ * The sum and xor prefixes are interleaved so that a query endpoint fetches both aggregates
+ * with one cache line and at most one page fault.
+ */
+struct MappedPrefixHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t element_bytes;
+    uint32_t accumulator_bytes;
+    uint32_t type_flags; // MAPPED_PREFIX_*_SIGNED bits
+    uint64_t elements;
+    uint64_t entries_offset;
+    uint64_t file_size;
+    char padding[16];
+};
+
+static_assert(sizeof(MappedPrefixHeader) == 64, "index header must stay 64 bytes");
+
+namespace prefix_detail
+{
+    const char MAPPED_PREFIX_MAGIC[8] = {'P', 'R', 'E', 'F', 'I', 'D', 'X', '\0'};
+    // Version 2 records the signedness of T and Acc in type_flags.
+    const uint32_t MAPPED_PREFIX_VERSION = 2;
+    const uint32_t MAPPED_PREFIX_ELEMENT_SIGNED = 1;
+    const uint32_t MAPPED_PREFIX_ACCUMULATOR_SIGNED = 2;
+
+    /**
+     * @brief type_flags of an index over T with accumulator Acc; together with the sizes it
+     *        tells int from unsigned, so an index is never reinterpreted with the wrong sign.
+     */
+    template <typename T, typename Acc>
+    uint32_t mapped_prefix_type_flags()
+    {
+        return (std::is_signed<T>::value ? MAPPED_PREFIX_ELEMENT_SIGNED : 0) |
+               (std::is_signed<Acc>::value ? MAPPED_PREFIX_ACCUMULATOR_SIGNED : 0);
+    }
+}
+
+/**
+ * @brief Builds a prefix index file from a stream of elements.
+ *
+ * The index is written to "<path>.tmp" and renamed over path by finish(), so concurrent
+ * readers only ever see a complete index. Destroying an unfinished writer removes the
+ * temporary file.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class MappedPrefixWriter
+{
+private:
+    string path;
+    string temp_path;
+    FILE *out;
+    size_t chunk;
+    ScanKernel kernel;
+    uint64_t elements;
+    Acc sum;
+    Acc xor_value;
+    vector<Acc> sums;
+    vector<Acc> xors;
+    vector<RangeAggregates<Acc>> entries;
+
+    void _write(const void *data, size_t bytes)
+    {
+        if (fwrite(data, 1, bytes, this->out) != bytes)
+        {
+            throw runtime_error("failed writing prefix index " + this->temp_path + ": " + strerror(errno));
+        }
+    }
+
+public:
+    /**
+     * @param path Index file to create.
+     * @param chunk_elements Elements scanned per step; bounds the writer's memory.
+     * @param kernel Scan kernel, see prefix_scan().
+     */
+    explicit MappedPrefixWriter(const string &path, size_t chunk_elements = 1 << 20,
+                                ScanKernel kernel = ScanKernel::Auto)
+        : path(path), temp_path(path + ".tmp"), out(nullptr), chunk(max<size_t>(chunk_elements, 1)),
+          kernel(kernel), elements(0), sum(SumOp<Acc>::identity()), xor_value(XorOp<Acc>::identity()),
+          sums(this->chunk), xors(this->chunk), entries(this->chunk)
+    {
+        this->out = fopen(this->temp_path.c_str(), "wb");
+        if (!this->out)
+        {
+            throw runtime_error("cannot create prefix index " + this->temp_path);
+        }
+        MappedPrefixHeader header = {};
+        this->_write(&header, sizeof(header));
+        RangeAggregates<Acc> first = {this->sum, this->xor_value};
+        this->_write(&first, sizeof(first));
+    }
+
+    MappedPrefixWriter(const MappedPrefixWriter &) = delete;
+    MappedPrefixWriter &operator=(const MappedPrefixWriter &) = delete;
+
+    ~MappedPrefixWriter()
+    {
+        if (this->out)
+        {
+            fclose(this->out);
+            unlink(this->temp_path.c_str());
+        }
+    }
+
+    /**
+     * @brief Appends count elements to the indexed array.
+     */
+    void append(const T *data, size_t count)
+    {
+        while (count > 0)
+        {
+            size_t step = min(count, this->chunk);
+            this->sum = prefix_scan<T, Acc, SumOp<Acc>>(data, this->sums.data(), step, this->sum, this->kernel);
+            this->xor_value = prefix_scan<T, Acc, XorOp<Acc>>(data, this->xors.data(), step, this->xor_value,
+                                                              this->kernel);
+            for (size_t i = 0; i < step; i++)
+            {
+                this->entries[i] = {this->sums[i], this->xors[i]};
+            }
+            this->_write(this->entries.data(), step * sizeof(RangeAggregates<Acc>));
+            this->elements += step;
+            data += step;
+            count -= step;
+        }
+    }
+
+    /**
+     * @brief Writes the header, syncs the file and moves it into place.
+     *
+     * @return uint64_t Number of elements indexed.
+     */
+    uint64_t finish()
+    {
+        MappedPrefixHeader header = {};
+        memcpy(header.magic, prefix_detail::MAPPED_PREFIX_MAGIC, sizeof(header.magic));
+        header.version = prefix_detail::MAPPED_PREFIX_VERSION;
+        header.element_bytes = sizeof(T);
+        header.accumulator_bytes = sizeof(Acc);
+        header.type_flags = prefix_detail::mapped_prefix_type_flags<T, Acc>();
+        header.elements = this->elements;
+        header.entries_offset = sizeof(MappedPrefixHeader);
+        header.file_size = header.entries_offset + (this->elements + 1) * sizeof(RangeAggregates<Acc>);
+
+        if (fseek(this->out, 0, SEEK_SET) != 0)
+        {
+            throw runtime_error("failed writing prefix index " + this->temp_path);
+        }
+        this->_write(&header, sizeof(header));
+        bool ok = fflush(this->out) == 0 && fsync(fileno(this->out)) == 0;
+        ok = fclose(this->out) == 0 && ok;
+        this->out = nullptr;
+        if (!ok || rename(this->temp_path.c_str(), this->path.c_str()) != 0)
+        {
+            unlink(this->temp_path.c_str());
+            throw runtime_error("failed writing prefix index " + this->path + ": " + strerror(errno));
+        }
+        return this->elements;
+    }
+};
+
+/**
+ * @brief Range sum and range xor queries in O(1) over an index file mapped read-only.
+ *
+ * Nothing is copied into the process: resident memory is whatever part of the index the
+ * page cache holds, shared with every other process mapping the same file.
+ *
+ * @tparam T Element type the index was built from.
+ * @tparam Acc Accumulator type the index was built with.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class MappedPrefixArray
+{
+private:
+    void *mapping;
+    size_t mapped_bytes;
+    long long N;
+    const RangeAggregates<Acc> *entries;
+
+public:
+    /**
+     * @brief Streams a file of raw native-order T values into a new index.
+     *
+     * @param input_path Binary input holding the array elements back to back.
+     * @param index_path Index file to create.
+     * @param chunk_elements Elements read and scanned per step.
+     * @return uint64_t Number of elements indexed.
+     */
+    static uint64_t build(const string &input_path, const string &index_path, size_t chunk_elements = 1 << 20,
+                          ScanKernel kernel = ScanKernel::Auto)
+    {
+        MappedPrefixWriter<T, Acc> writer(index_path, chunk_elements, kernel);
+        unique_ptr<FILE, int (*)(FILE *)> in(fopen(input_path.c_str(), "rb"), fclose);
+        if (!in)
+        {
+            throw runtime_error("cannot open " + input_path);
+        }
+        vector<T> buffer(max<size_t>(chunk_elements, 1));
+        size_t got, leftover = 0;
+        while ((got = fread(buffer.data(), 1, buffer.size() * sizeof(T), in.get())) > 0)
+        {
+            writer.append(buffer.data(), got / sizeof(T));
+            leftover = got % sizeof(T);
+        }
+        if (ferror(in.get()) || leftover != 0)
+        {
+            throw runtime_error(input_path + " is not a whole number of elements");
+        }
+        return writer.finish();
+    }
+
+    /**
+     * @brief Maps an index file and validates its header.
+     *
+     * Throws runtime_error unless the index was built with the same element and accumulator
+     * types: sizes and signedness must both match.
+     *
+     * @param path Index written by MappedPrefixWriter or build().
+     */
+    explicit MappedPrefixArray(const string &path)
+        : mapping(MAP_FAILED), mapped_bytes(0), N(0), entries(nullptr)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw runtime_error("cannot open prefix index " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(MappedPrefixHeader))
+        {
+            ::close(fd);
+            throw runtime_error(path + " is not a prefix index");
+        }
+        this->mapped_bytes = info.st_size;
+        this->mapping = mmap(nullptr, this->mapped_bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (this->mapping == MAP_FAILED)
+        {
+            throw runtime_error("cannot map prefix index " + path);
+        }
+
+        const MappedPrefixHeader *header = static_cast<const MappedPrefixHeader *>(this->mapping);
+        bool valid = memcmp(header->magic, prefix_detail::MAPPED_PREFIX_MAGIC, sizeof(header->magic)) == 0 &&
+                     header->version == prefix_detail::MAPPED_PREFIX_VERSION &&
+                     header->element_bytes == sizeof(T) && header->accumulator_bytes == sizeof(Acc) &&
+                     header->type_flags == prefix_detail::mapped_prefix_type_flags<T, Acc>() &&
+                     header->entries_offset == sizeof(MappedPrefixHeader) &&
+                     header->file_size == this->mapped_bytes &&
+                     header->file_size == header->entries_offset + (header->elements + 1) * sizeof(RangeAggregates<Acc>);
+        if (!valid)
+        {
+            munmap(this->mapping, this->mapped_bytes);
+            throw runtime_error(path + " is not a compatible prefix index");
+        }
+        this->N = header->elements;
+        this->entries = reinterpret_cast<const RangeAggregates<Acc> *>(
+            static_cast<const char *>(this->mapping) + header->entries_offset);
+        // Queries touch two scattered entries; read-ahead would only evict useful pages.
+        madvise(this->mapping, this->mapped_bytes, MADV_RANDOM);
+    }
+
+    MappedPrefixArray(const MappedPrefixArray &) = delete;
+    MappedPrefixArray &operator=(const MappedPrefixArray &) = delete;
+
+    ~MappedPrefixArray()
+    {
+        munmap(this->mapping, this->mapped_bytes);
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->N))
+        {
+            return invalid_query();
+        }
+        return SumOp<Acc>::subtract(this->entries[r + 1].sum, this->entries[l].sum);
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->N))
+        {
+            return invalid_query();
+        }
+        return XorOp<Acc>::subtract(this->entries[r + 1].xor_value, this->entries[l].xor_value);
+    }
+
+    /**
+     * @brief Answers a batch of queries, see PrefixArray::range_queries().
+     *
+     * Sorting pays off here once the index exceeds the page cache: the left endpoints of a
+     * sorted batch are read in one forward sweep instead of faulting pages in at random.
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, RangeAggregates<Acc> *results,
+                         bool sort_queries = false) const
+    {
+        const RangeAggregates<Acc> *entries = this->entries;
+        return answer_range_queries(this->N, queries, count, results, {invalid_query(), invalid_query()},
+                                    sort_queries, [entries](long long l, long long r) -> RangeAggregates<Acc>
+                                    {
+                                        return {SumOp<Acc>::subtract(entries[r + 1].sum, entries[l].sum),
+                                                XorOp<Acc>::subtract(entries[r + 1].xor_value, entries[l].xor_value)};
+                                    });
+    }
+};
+
+#endif // MAPPED_PREFIX_ARRAY_H
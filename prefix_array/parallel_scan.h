@@ -0,0 +1,146 @@
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include "prefix_scan.h"
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @brief Allocator whose construct() default-initialises, so that a vector of trivial
+ *        values can be sized without writing to (and first-touching) its pages.
+ */
+template <typename T, typename Base = std::allocator<T>>
+class default_init_allocator : public Base
+{
+public:
+    template <typename U>
+    struct rebind
+    {
+        typedef default_init_allocator<U, typename std::allocator_traits<Base>::template rebind_alloc<U>> other;
+    };
+
+    using Base::Base;
+
+    template <typename U>
+    void construct(U *ptr)
+    {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&...args)
+    {
+        std::allocator_traits<Base>::construct(static_cast<Base &>(*this), ptr, std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * @brief Combination of in[0..n), starting from carry.
+ */
+template <typename T, typename Acc, typename Op>
+Acc prefix_reduce(const T *in, size_t n, Acc carry = Op::identity())
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        carry = Op::combine(carry, Acc(in[i]));
+    }
+    return carry;
+}
+
+namespace prefix_detail
+{
+    /**
+     * @brief Runs work(t) for t in [0, threads) on its own thread, optionally pinned to CPU t.
+     */
+    template <typename Work>
+    void run_on_threads(unsigned threads, bool pin, const Work &work)
+    {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++)
+        {
+            pool.emplace_back([&, t]
+                              {
+#ifdef __linux__
+                if (pin)
+                {
+                    cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(t % std::max(1u, std::thread::hardware_concurrency()), &set);
+                    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                }
+#endif
+                work(t); });
+        }
+        for (std::thread &th : pool)
+        {
+            th.join();
+        }
+    }
+}
+
+/**
+ * @brief Multi-threaded inclusive prefix scan with the same result as prefix_scan().
+ *
+ * The input is split into one contiguous block per thread:
+ * 1. every thread reduces its block to a block total (read-only),
+ * 2. the block totals are scanned sequentially into per-block carries,
+ * 3. every thread scans its block again, seeded with its carry.
+ * Reducing first instead of scanning first means the output is written once rather than
+ * twice. Step 3 is the first write to each block's output, so when the output was allocated
+ * without initialisation (see default_init_allocator) its pages are placed on the NUMA node
+ * of the thread that owns the block. Pinning keeps each block on the same CPU in both passes.
+ *
+ * @param threads Number of threads; 0 uses all hardware threads.
+ * @param pin Pin thread t to CPU t (Linux only).
+ * @return Acc The last prefix value.
+ */
+template <typename T, typename Acc, typename Op>
+Acc parallel_prefix_scan(const T *in, Acc *out, size_t n, unsigned threads = 0,
+                         ScanKernel kernel = ScanKernel::Auto, bool pin = false,
+                         Acc carry = Op::identity())
+{
+    // Below this many elements per thread the thread start-up costs more than it saves.
+    const size_t MIN_BLOCK = 1 << 16;
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, n / MIN_BLOCK));
+    if (threads <= 1)
+    {
+        return prefix_scan<T, Acc, Op>(in, out, n, carry, kernel);
+    }
+
+    size_t block = (n + threads - 1) / threads;
+    std::vector<Acc> carries(threads + 1);
+
+    prefix_detail::run_on_threads(threads, pin, [&](unsigned t)
+                                  {
+        size_t begin = std::min(n, t * block);
+        size_t end = std::min(n, begin + block);
+        carries[t + 1] = prefix_reduce<T, Acc, Op>(in + begin, end - begin); });
+
+    carries[0] = carry;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        carries[t + 1] = Op::combine(carries[t], carries[t + 1]);
+    }
+
+    prefix_detail::run_on_threads(threads, pin, [&](unsigned t)
+                                  {
+        size_t begin = std::min(n, t * block);
+        size_t end = std::min(n, begin + block);
+        prefix_scan<T, Acc, Op>(in + begin, out + begin, end - begin, carries[t], kernel); });
+
+    return carries[threads];
+}
+
+#endif // PARALLEL_SCAN_H
@@ -1,89 +1,243 @@
-#include <iostream>
+#include "prefix_array.h"
+#include "mapped_prefix_array.h"
+#include "compressed_prefix_array.h"
+#include "fast_io.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
 #include <vector>
-#include <climits>
 
 using namespace std;
 
-class PrefixArray
+/**
+ * @brief Reads q queries, answers them one batch at a time and writes the answers.
+ *
+ * Works with any structure providing size(), invalid_query() and range_queries().
+ */
+template <typename Array>
+void answer_queries(const Array &arr, long long q, FastReader &in, FastWriter &out, bool binary, bool sort_queries,
+                    bool interactive)
 {
-private:
-    int N;
-    vector<int> prefix_sum_array;
-    vector<int> prefix_xor_array;
-
-    void _construct_prefix_arrays(vector<int> &arr)
+    const size_t batch = interactive ? 1 : 1 << 16;
+    vector<RangeQuery> queries(batch);
+    vector<RangeAggregates<int64_t>> results(batch);
+    vector<int64_t> answers(batch);
+    while (q > 0)
     {
-        this->N = arr.size();
-        if (arr.size() == 0)
+        size_t count = min<long long>(q, batch);
+        if (binary)
+        {
+            count = in.read_binary(queries.data(), count);
+        }
+        else
+        {
+            size_t read = 0;
+            while (read < count && in.read(queries[read].l) && in.read(queries[read].r))
+            {
+                read++;
+            }
+            count = read;
+        }
+        if (count == 0)
         {
-            return;
+            break;
         }
+        q -= count;
 
-        this->prefix_sum_array = arr;
-        this->prefix_xor_array = arr;
+        arr.range_queries(queries.data(), count, results.data(), sort_queries);
+        for (size_t i = 0; i < count; i++)
+        {
+            // The xor of int elements always fits in an int, so only an out-of-bounds query
+            // leaves the sentinel in xor_value; the sum alone could reach it.
+            bool valid = results[i].xor_value != arr.invalid_query();
+            answers[i] = valid ? results[i].sum + results[i].xor_value : arr.invalid_query();
+        }
 
-        for (int i = 1; i < arr.size(); i++)
+        if (binary)
+        {
+            out.write_binary(answers.data(), count);
+            continue;
+        }
+        for (size_t i = 0; i < count; i++)
         {
-            this->prefix_sum_array[i] += this->prefix_sum_array[i - 1];
-            this->prefix_xor_array[i] ^= this->prefix_xor_array[i - 1];
+            out.write(answers[i]);
+            out.write_char('\n');
+        }
+        if (interactive)
+        {
+            out.flush();
         }
     }
+}
 
-public:
-    PrefixArray(vector<int> &arr)
+/**
+ * @brief Reads an array and answers range queries with the sum plus the xor of each range.
+ *
+ * Text mode reads "n q", the n elements and q pairs "l r", and prints one answer per line.
+ * An out-of-bounds query prints INT64_MIN (-9223372036854775808). The original driver
+ * printed INT_MIN + INT_MIN, which overflowed to 0 and could not be told apart from a
+ * real answer. A negative n, or input that ends before all n elements, is reported on
+ * stderr with exit status 1.
+ * Queries are answered in batches through PrefixArray::range_queries() with buffered I/O;
+ * when stdin is a terminal, prompts are shown and every answer is flushed immediately.
+ *
+ * Options:
+ *   --binary  read int64 n, int64 q, n int32 elements and q int64 (l, r) pairs, and write
+ *             q int64 answers, all in native byte order
+ *   --sort    answer each batch in increasing l order for locality
+ *   --compressed
+ *             answer from a CompressedPrefixArray and report its size and the query time
+ *             on stderr
+ *   --index <file>
+ *             answer queries from a prefix index built by --build-index; the input then
+ *             starts with q (int64 q in binary mode) and has no array
+ *   --build-index <elements.bin> <file>
+ *             stream a file of raw int32 elements into a prefix index and exit
+ */
+int main(int argc, char **argv)
+{
+    bool binary = false, sort_queries = false, compressed = false;
+    string index_path, build_input;
+    for (int i = 1; i < argc; i++)
     {
-        this->_construct_prefix_arrays(arr);
+        string arg = argv[i];
+        if (arg == "--binary")
+            binary = true;
+        else if (arg == "--sort")
+            sort_queries = true;
+        else if (arg == "--compressed")
+            compressed = true;
+        else if (arg == "--index" && i + 1 < argc)
+            index_path = argv[++i];
+        else if (arg == "--build-index" && i + 2 < argc)
+        {
+            build_input = argv[++i];
+            index_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [--binary] [--sort] [--compressed]\n"
+                    "          [--index <file> | --build-index <elements.bin> <file>]\n",
+                    argv[0]);
+            return 1;
+        }
     }
 
-    int range_sum_query(int l, int r)
+    if (!build_input.empty())
     {
-        if (l < 0 || r >= this->N)
+        try
         {
-            return INT_MIN;
+            uint64_t n = MappedPrefixArray<int>::build(build_input, index_path);
+            printf("Indexed %llu elements into %s\n", (unsigned long long)n, index_path.c_str());
         }
-        if (l == 0)
+        catch (const exception &e)
         {
-            return this->prefix_sum_array[r];
+            fprintf(stderr, "%s\n", e.what());
+            return 1;
         }
-        return this->prefix_sum_array[r] - this->prefix_sum_array[l - 1];
+        return 0;
     }
+    bool interactive = !binary && isatty(fileno(stdin));
+
+    FastReader in(stdin, 1 << 20);
+    FastWriter out(stdout, 1 << 20);
+    auto prompt = [&](const char *text)
+    {
+        if (interactive)
+        {
+            fputs(text, stdout);
+            fflush(stdout);
+        }
+    };
 
-    int range_xor_query(int l, int r)
+    long long n = 0, q = 0;
+    if (!index_path.empty())
     {
-        if (l < 0 || r >= this->N)
+        try
         {
-            return INT_MIN;
+            MappedPrefixArray<int> arr(index_path);
+            prompt("Enter the number of range queries \n");
+            if (binary)
+            {
+                in.read_binary(&q, 1);
+            }
+            else
+            {
+                in.read(q);
+            }
+            if (interactive)
+            {
+                printf("Enter %lld queries in the form l r \n", q);
+                fflush(stdout);
+            }
+            answer_queries(arr, q, in, out, binary, sort_queries, interactive);
         }
-        if (l == 0)
+        catch (const exception &e)
         {
-            return this->prefix_xor_array[r];
+            fprintf(stderr, "%s\n", e.what());
+            return 1;
         }
-        return this->prefix_xor_array[r] ^ this->prefix_xor_array[l - 1];
+        return 0;
     }
-};
 
-int main()
-{
-    int n, q;
-    cout << "Enter the number of elements in the array and number of range queries \n";
-    cin >> n >> q;
+    prompt("Enter the number of elements in the array and number of range queries \n");
+    if (binary)
+    {
+        in.read_binary(&n, 1);
+        in.read_binary(&q, 1);
+    }
+    else
+    {
+        in.read(n);
+        in.read(q);
+    }
+    if (n < 0)
+    {
+        fprintf(stderr, "Invalid number of elements %lld: expected n >= 0\n", n);
+        return 1;
+    }
 
     vector<int> inputArray(n);
-    cout << "Enter the array elements \n";
-    for (int i = 0; i < n; i++)
+    prompt("Enter the array elements \n");
+    long long read = 0;
+    if (binary)
+    {
+        read = in.read_binary(inputArray.data(), n);
+    }
+    else
     {
-        cin >> inputArray[i];
+        while (read < n && in.read(inputArray[read]))
+        {
+            read++;
+        }
+    }
+    if (read < n)
+    {
+        fprintf(stderr, "Input ended after %lld of %lld elements\n", read, n);
+        return 1;
     }
 
-    PrefixArray arr(inputArray);
+    if (interactive)
+    {
+        printf("Enter %lld queries in the form l r \n", q);
+        fflush(stdout);
+    }
 
-    cout << "Enter " << q << " queries in the form l r \n";
-    while (q--)
+    if (compressed)
     {
-        int l, r;
-        cin >> l >> r;
-        cout << arr.range_sum_query(l, r) + arr.range_xor_query(l, r) << endl;
+        CompressedPrefixArray<int> arr(inputArray);
+        auto start = chrono::steady_clock::now();
+        answer_queries(arr, q, in, out, binary, sort_queries, interactive);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        out.flush();
+        fprintf(stderr, "compressed %zu -> %zu bytes, ratio %.2f, %.2f bits per position (sum+xor), %.3f s for queries\n",
+                arr.uncompressed_bytes(), arr.memory_bytes(), arr.compression_ratio(), arr.bits_per_value(), seconds);
+        return 0;
     }
 
+    PrefixArray<int> arr(inputArray);
+    answer_queries(arr, q, in, out, binary, sort_queries, interactive);
     return 0;
 }
@@ -0,0 +1,166 @@
+#ifndef PREFIX_ARRAY_H
+#define PREFIX_ARRAY_H
+
+#include "prefix_ops.h"
+#include "range_query.h"
+#include "prefix_scan.h"
+#include "parallel_scan.h"
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Prefix values of an array under one invertible operator, answering range
+ *        queries in O(1).
+ *
+ * prefix[0] holds the identity and prefix[i + 1] the combination of arr[0..i], so a query
+ * is a single subtract() with no special case for l == 0.
+ *
+ * With threads != 1 the prefix values are built by parallel_prefix_scan(); the storage is
+ * left uninitialised until then so that the building threads first-touch their own blocks.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type; wide by default so that sums do not overflow.
+ * @tparam Op Operator, see prefix_ops.h.
+ */
+template <typename T, typename Acc = wide_accumulator_t<T>, typename Op = SumOp<Acc>>
+class PrefixScan
+{
+private:
+    long long N;
+    vector<Acc, default_init_allocator<Acc>> prefix;
+
+public:
+    /**
+     * @param kernel Scan kernel, see prefix_scan().
+     * @param threads Construction threads; 0 uses all hardware threads.
+     */
+    PrefixScan(const T *data, size_t n, ScanKernel kernel = ScanKernel::Auto, unsigned threads = 1)
+        : N(n), prefix(n + 1)
+    {
+        this->prefix[0] = Op::identity();
+        parallel_prefix_scan<T, Acc, Op>(data, this->prefix.data() + 1, n, threads, kernel);
+    }
+
+    explicit PrefixScan(const vector<T> &arr, ScanKernel kernel = ScanKernel::Auto, unsigned threads = 1)
+        : PrefixScan(arr.data(), arr.size(), kernel, threads)
+    {
+    }
+
+    /**
+     * @brief Value returned for out-of-range queries, see range_query.h.
+     */
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    bool valid_range(long long l, long long r) const
+    {
+        return ::valid_range(l, r, this->N);
+    }
+
+    /**
+     * @brief Combination of arr[l..r], or invalid_query() if the range is out of bounds.
+     */
+    Acc query(long long l, long long r) const
+    {
+        if (!this->valid_range(l, r))
+        {
+            return invalid_query();
+        }
+        return Op::subtract(this->prefix[r + 1], this->prefix[l]);
+    }
+
+    /**
+     * @brief The N + 1 prefix values, starting with the identity.
+     */
+    const Acc *data() const
+    {
+        return this->prefix.data();
+    }
+};
+
+/**
+ * @brief Both aggregates of one range, as produced by PrefixArray::range_queries().
+ */
+template <typename Acc>
+struct RangeAggregates
+{
+    Acc sum;
+    Acc xor_value;
+};
+
+/**
+ * @brief Range sum and range xor queries in O(1) over a fixed array.
+ *
+ * @tparam T Element type (integral).
+ * @tparam Acc Accumulator type; 64-bit by default so that sums of int data do not overflow.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class PrefixArray
+{
+private:
+    PrefixScan<T, Acc, SumOp<Acc>> prefix_sum_array;
+    PrefixScan<T, Acc, XorOp<Acc>> prefix_xor_array;
+
+public:
+    explicit PrefixArray(const vector<T> &arr, ScanKernel kernel = ScanKernel::Auto, unsigned threads = 1)
+        : prefix_sum_array(arr, kernel, threads), prefix_xor_array(arr, kernel, threads)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->prefix_sum_array.size();
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        return this->prefix_sum_array.query(l, r);
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        return this->prefix_xor_array.query(l, r);
+    }
+
+    /**
+     * @brief Answers a batch of queries, computing the sum and the xor of each range together.
+     *
+     * Each query is bounds-checked once and reads its two endpoints from both prefix arrays
+     * back to back, instead of going through range_sum_query() and range_xor_query().
+     * Out-of-bounds queries get invalid_query() in both fields.
+     *
+     * @param queries The ranges to answer.
+     * @param count Number of queries.
+     * @param results Output, one entry per query in input order.
+     * @param sort_queries Answer in increasing l order for locality, see query_order().
+     * @return size_t Number of in-bounds queries.
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, RangeAggregates<Acc> *results,
+                         bool sort_queries = false) const
+    {
+        const Acc *sums = this->prefix_sum_array.data();
+        const Acc *xors = this->prefix_xor_array.data();
+        return answer_range_queries(this->size(), queries, count, results, {invalid_query(), invalid_query()},
+                                    sort_queries, [sums, xors](long long l, long long r) -> RangeAggregates<Acc>
+                                    {
+                                        return {SumOp<Acc>::subtract(sums[r + 1], sums[l]),
+                                                XorOp<Acc>::subtract(xors[r + 1], xors[l])};
+                                    });
+    }
+};
+
+#endif // PREFIX_ARRAY_H
@@ -0,0 +1,182 @@
+#ifndef PREFIX_ARRAY_2D_H
+#define PREFIX_ARRAY_2D_H
+
+#include "prefix_ops.h"
+#include "range_query.h"
+#include "prefix_scan.h"
+#include "parallel_scan.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief 2D prefix values (summed-area table) of a row-major grid under one commutative
+ *        invertible operator, answering rectangle queries in O(1).
+ *
+ * The table has one zero (identity) row and column in front of the data, so every query is
+ * the same four lookups without bounds special cases, and each row is padded to a whole
+ * number of cache lines so that the two lookups in a row share at most two lines.
+ *
+ * Construction runs in two passes:
+ * 1. every row is prefix-scanned with the SIMD kernel of prefix_scan(), rows split across threads;
+ * 2. every row is combined into the next one, column tile by column tile, so the previous
+ *    row's tile is still in L1 when the next row reads it. Tiles are split across threads.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ * @tparam Op Commutative invertible operator, see prefix_ops.h.
+ */
+template <typename T, typename Acc = wide_accumulator_t<T>, typename Op = SumOp<Acc>>
+class SummedAreaTable
+{
+private:
+    // Columns per tile of the column pass: 4 KiB of 64-bit accumulators.
+    static const size_t TILE = 512;
+
+    long long rows;
+    long long cols;
+    size_t stride;
+    vector<Acc, default_init_allocator<Acc>> table;
+
+    Acc *row(size_t r)
+    {
+        return this->table.data() + r * this->stride;
+    }
+
+    const Acc *row(size_t r) const
+    {
+        return this->table.data() + r * this->stride;
+    }
+
+    void _scan_rows(const T *data, size_t first, size_t last, ScanKernel kernel)
+    {
+        for (size_t r = first; r < last; r++)
+        {
+            Acc *out = this->row(r + 1);
+            out[0] = Op::identity();
+            prefix_scan<T, Acc, Op>(data + r * this->cols, out + 1, this->cols, Op::identity(), kernel);
+        }
+    }
+
+    void _combine_columns(size_t first, size_t last)
+    {
+        for (size_t r = 2; r <= (size_t)this->rows; r++)
+        {
+            const Acc *__restrict above = this->row(r - 1);
+            Acc *__restrict current = this->row(r);
+            for (size_t c = first; c < last; c++)
+            {
+                current[c] = Op::combine(above[c], current[c]);
+            }
+        }
+    }
+
+public:
+    /**
+     * @param data Row-major grid of rows x cols elements.
+     * @param threads Construction threads; 0 uses all hardware threads.
+     */
+    SummedAreaTable(const T *data, size_t rows, size_t cols, unsigned threads = 1,
+                    ScanKernel kernel = ScanKernel::Auto)
+        : rows(rows), cols(cols)
+    {
+        const size_t per_line = max<size_t>(1, 64 / sizeof(Acc));
+        this->stride = (cols + 1 + per_line - 1) / per_line * per_line;
+        this->table.resize((rows + 1) * this->stride);
+        fill(this->row(0), this->row(1), Op::identity());
+
+        if (threads == 0)
+        {
+            threads = max(1u, thread::hardware_concurrency());
+        }
+        threads = (unsigned)min<size_t>(threads, max<size_t>(1, rows * cols / (1 << 16)));
+
+        size_t row_block = (rows + threads - 1) / max(1u, threads);
+        prefix_detail::run_on_threads(threads, false, [&](unsigned t)
+                                      {
+            size_t first = min(rows, t * row_block);
+            this->_scan_rows(data, first, min(rows, first + row_block), kernel); });
+
+        size_t tiles = (cols + 1 + TILE - 1) / TILE;
+        unsigned column_threads = (unsigned)min<size_t>(threads, tiles);
+        size_t tiles_per_thread = (tiles + column_threads - 1) / max(1u, column_threads);
+        prefix_detail::run_on_threads(column_threads, false, [&](unsigned t)
+                                      {
+            size_t end_tile = min(tiles, (t + 1) * tiles_per_thread);
+            for (size_t tile = t * tiles_per_thread; tile < end_tile; tile++)
+            {
+                this->_combine_columns(tile * TILE, min<size_t>(cols + 1, (tile + 1) * TILE));
+            } });
+    }
+
+    SummedAreaTable(const vector<T> &data, size_t rows, size_t cols, unsigned threads = 1,
+                    ScanKernel kernel = ScanKernel::Auto)
+        : SummedAreaTable(data.data(), rows, cols, threads, kernel)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    bool valid_range(long long r1, long long c1, long long r2, long long c2) const
+    {
+        return r1 >= 0 && c1 >= 0 && r1 <= r2 && c1 <= c2 && r2 < this->rows && c2 < this->cols;
+    }
+
+    /**
+     * @brief Combination of the rectangle [r1..r2] x [c1..c2], or invalid_query() if it is
+     *        out of bounds.
+     */
+    Acc query(long long r1, long long c1, long long r2, long long c2) const
+    {
+        if (!this->valid_range(r1, c1, r2, c2))
+        {
+            return invalid_query();
+        }
+        const Acc *top = this->row(r1);
+        const Acc *bottom = this->row(r2 + 1);
+        return Op::subtract(Op::subtract(bottom[c2 + 1], top[c2 + 1]),
+                            Op::subtract(bottom[c1], top[c1]));
+    }
+};
+
+/**
+ * @brief 2D counterpart of PrefixArray: rectangle sum and xor queries in O(1) over a grid.
+ *
+ * @tparam T Element type (integral).
+ * @tparam Acc Accumulator type.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class PrefixArray2D
+{
+private:
+    SummedAreaTable<T, Acc, SumOp<Acc>> prefix_sum_table;
+    SummedAreaTable<T, Acc, XorOp<Acc>> prefix_xor_table;
+
+public:
+    PrefixArray2D(const vector<T> &grid, size_t rows, size_t cols, unsigned threads = 1)
+        : prefix_sum_table(grid, rows, cols, threads), prefix_xor_table(grid, rows, cols, threads)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    Acc range_sum_query(long long r1, long long c1, long long r2, long long c2) const
+    {
+        return this->prefix_sum_table.query(r1, c1, r2, c2);
+    }
+
+    Acc range_xor_query(long long r1, long long c1, long long r2, long long c2) const
+    {
+        return this->prefix_xor_table.query(r1, c1, r2, c2);
+    }
+};
+
+#endif // PREFIX_ARRAY_2D_H
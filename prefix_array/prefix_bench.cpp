@@ -0,0 +1,763 @@
+#include "prefix_array.h"
+#include "prefix_array_2d.h"
+#include "compressed_prefix_array.h"
+#include "segment_tree.h"
+#include "sparse_table.h"
+#include "streaming_prefix_array.h"
+#include "updatable_prefix_array.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+
+using namespace std;
+
+namespace
+{
+    typedef chrono::steady_clock Clock;
+
+    const char *kernel_name(ScanKernel kernel)
+    {
+        switch (kernel)
+        {
+        case ScanKernel::Scalar:
+            return "scalar";
+        case ScanKernel::SSE41:
+            return "sse4.1";
+        case ScanKernel::AVX2:
+            return "avx2";
+        default:
+            return "auto";
+        }
+    }
+
+    /**
+     * @brief Times one scan kernel, keeping the best of repeat runs.
+     */
+    template <typename Op>
+    double time_scan(const vector<int> &in, vector<int64_t> &out, ScanKernel kernel, int repeat)
+    {
+        double best = 0;
+        for (int rep = 0; rep < repeat; rep++)
+        {
+            auto start = Clock::now();
+            prefix_scan<int, int64_t, Op>(in.data(), out.data(), in.size(), Op::identity(), kernel);
+            double seconds = chrono::duration<double>(Clock::now() - start).count();
+            best = rep == 0 ? seconds : min(best, seconds);
+        }
+        return best;
+    }
+
+    template <typename Op>
+    void run(const char *name, const vector<int> &in, int repeat)
+    {
+        size_t n = in.size();
+        vector<int64_t> reference(n), out(n);
+        prefix_scan<int, int64_t, Op>(in.data(), reference.data(), n, Op::identity(), ScanKernel::Scalar);
+
+        for (ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2})
+        {
+            if (kernel != ScanKernel::Scalar && best_scan_kernel() < kernel)
+            {
+                printf("%-4s %-7s not supported by this CPU\n", name, kernel_name(kernel));
+                continue;
+            }
+            double seconds = time_scan<Op>(in, out, kernel, repeat);
+            double bytes = n * (sizeof(int) + sizeof(int64_t));
+            printf("%-4s %-7s %10.3f ms %8.3f ns/elem %8.2f GB/s %s\n", name, kernel_name(kernel),
+                   seconds * 1e3, seconds * 1e9 / n, bytes / seconds / 1e9,
+                   out == reference ? "ok" : "MISMATCH");
+        }
+    }
+
+    /**
+     * @brief Best time of repeat runs of f(), each writing into a fresh, untouched buffer.
+     *
+     * Every run gets its own anonymous mapping, so every run pays the same first-touch page
+     * faults; a heap buffer could reuse pages an earlier run already faulted in.
+     *
+     * @param expected If not null, every run's output is compared with it, outside the timing.
+     * @param ok Cleared if an output differs from expected.
+     */
+    template <typename F>
+    double time_fresh(size_t n, int repeat, const F &f, const int64_t *expected = nullptr, bool *ok = nullptr)
+    {
+        double best = 0;
+        size_t bytes = max<size_t>(n, 1) * sizeof(int64_t);
+        for (int rep = 0; rep < repeat; rep++)
+        {
+            void *mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapped == MAP_FAILED)
+            {
+                perror("mmap");
+                exit(1);
+            }
+            auto start = Clock::now();
+            f(static_cast<int64_t *>(mapped));
+            double seconds = chrono::duration<double>(Clock::now() - start).count();
+            if (expected != nullptr && !equal(expected, expected + n, static_cast<const int64_t *>(mapped)))
+            {
+                *ok = false;
+            }
+            munmap(mapped, bytes);
+            best = rep == 0 ? seconds : min(best, seconds);
+        }
+        return best;
+    }
+
+    /**
+     * @brief Measures how parallel_prefix_scan() scales with threads against the bandwidth of a
+     *        plain widening copy (same 12 bytes of traffic per element) on all threads.
+     */
+    void scaling(const vector<int> &in, int repeat, bool pin)
+    {
+        size_t n = in.size();
+        double bytes = n * (sizeof(int) + sizeof(int64_t));
+        unsigned hw = max(1u, thread::hardware_concurrency());
+        vector<int64_t> reference(n);
+        prefix_scan<int, int64_t, SumOp<int64_t>>(in.data(), reference.data(), n, 0, ScanKernel::Scalar);
+
+        double copy = time_fresh(n, repeat, [&](int64_t *out)
+                                 { prefix_detail::run_on_threads(hw, pin, [&](unsigned t)
+                                                                 {
+                size_t block = (n + hw - 1) / hw;
+                size_t begin = min(n, t * block), end = min(n, begin + block);
+                copy_n(in.data() + begin, end - begin, out + begin); }); });
+        printf("\nparallel sum scan (fresh output, %s), copy bandwidth on %u threads: %.2f GB/s\n",
+               pin ? "pinned" : "unpinned", hw, bytes / copy / 1e9);
+
+        vector<unsigned> counts;
+        for (unsigned t = 1; t < hw; t *= 2)
+        {
+            counts.push_back(t);
+        }
+        counts.push_back(hw);
+        for (unsigned threads : counts)
+        {
+            bool ok = true;
+            double seconds = time_fresh(
+                n, repeat, [&](int64_t *out)
+                { parallel_prefix_scan<int, int64_t, SumOp<int64_t>>(in.data(), out, n, threads, ScanKernel::Auto, pin); },
+                reference.data(), &ok);
+            printf("threads %3u %10.3f ms %8.2f GB/s %6.1f%% of copy bandwidth %s\n", threads, seconds * 1e3,
+                   bytes / seconds / 1e9, 100 * copy / seconds, ok ? "ok" : "MISMATCH");
+        }
+    }
+
+    /**
+     * @brief Builds a summed-area table over data on threads threads and compares the whole
+     *        grid and samples random rectangles of at most 256 x 256 cells against a naive
+     *        double loop; out-of-bounds rectangles must return invalid_query().
+     */
+    bool check_rectangles(const int *data, size_t rows, size_t cols, unsigned threads, size_t samples,
+                          mt19937_64 &rng)
+    {
+        SummedAreaTable<int, int64_t> table(data, rows, cols, threads);
+        auto naive = [&](size_t r1, size_t c1, size_t r2, size_t c2)
+        {
+            int64_t sum = 0;
+            for (size_t r = r1; r <= r2; r++)
+            {
+                for (size_t c = c1; c <= c2; c++)
+                {
+                    sum += data[r * cols + c];
+                }
+            }
+            return sum;
+        };
+
+        bool ok = table.query(0, 0, rows, cols - 1) == table.invalid_query() &&
+                  table.query(0, 0, rows - 1, cols) == table.invalid_query();
+        if (rows == 0 || cols == 0)
+        {
+            return ok && table.query(0, 0, 0, 0) == table.invalid_query();
+        }
+        ok = ok && table.query(0, 0, rows - 1, cols - 1) == naive(0, 0, rows - 1, cols - 1);
+        for (size_t q = 0; q < samples; q++)
+        {
+            size_t r1 = rng() % rows, c1 = rng() % cols;
+            size_t r2 = r1 + rng() % min<size_t>(rows - r1, 256), c2 = c1 + rng() % min<size_t>(cols - c1, 256);
+            ok = ok && table.query(r1, c1, r2, c2) == naive(r1, c1, r2, c2);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Times building a summed-area table over a square grid of about n elements, and
+     *        random rectangle queries on it.
+     */
+    void grid(const vector<int> &in, int repeat)
+    {
+        size_t side = (size_t)sqrt((double)in.size());
+        unsigned hw = max(1u, thread::hardware_concurrency());
+        printf("\nsummed-area table %zu x %zu\n", side, side);
+
+        for (unsigned threads : {1u, hw})
+        {
+            double best = 0;
+            for (int rep = 0; rep < repeat; rep++)
+            {
+                auto start = Clock::now();
+                SummedAreaTable<int, int64_t> table(in.data(), side, side, threads);
+                double seconds = chrono::duration<double>(Clock::now() - start).count();
+                best = rep == 0 ? seconds : min(best, seconds);
+            }
+            printf("build, threads %3u %10.3f ms %8.3f ns/cell\n", threads, best * 1e3, best * 1e9 / (side * side));
+        }
+
+        SummedAreaTable<int, int64_t> table(in.data(), side, side, hw);
+        const size_t queries = 1000000;
+        vector<long long> corners(4 * queries);
+        mt19937_64 rng(7);
+        for (size_t q = 0; q < queries; q++)
+        {
+            long long r1 = rng() % side, c1 = rng() % side;
+            corners[4 * q] = r1;
+            corners[4 * q + 1] = c1;
+            corners[4 * q + 2] = r1 + rng() % (side - r1);
+            corners[4 * q + 3] = c1 + rng() % (side - c1);
+        }
+        int64_t checksum = 0;
+        auto start = Clock::now();
+        for (size_t q = 0; q < queries; q++)
+        {
+            checksum += table.query(corners[4 * q], corners[4 * q + 1], corners[4 * q + 2], corners[4 * q + 3]);
+        }
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+        printf("random rectangle queries %8.2f ns/query (checksum %lld)\n", seconds * 1e9 / queries, (long long)checksum);
+
+        // Edge shapes are long enough to be split over several threads; the square grid is
+        // checked on at least two threads even on a single-core machine.
+        unsigned several = max(2u, hw);
+        size_t line = min<size_t>(in.size(), (3 << 16) + 7);
+        bool ok = check_rectangles(in.data(), side, side, several, 1000, rng);
+        for (auto shape : {make_pair((size_t)0, line), make_pair((size_t)1, line), make_pair(line, (size_t)1)})
+        {
+            ok = check_rectangles(in.data(), shape.first, shape.second, several, 1000, rng) && ok;
+        }
+        printf("rectangle queries against naive sums (%zu x %zu, 0 x %zu, 1 x %zu, %zu x 1) %s\n", side, side, line,
+               line, line, ok ? "ok" : "MISMATCH");
+    }
+
+    /**
+     * @brief Best time per query of repeat runs of a random query batch against arr.
+     */
+    template <typename Array>
+    double time_queries(const Array &arr, const vector<RangeQuery> &queries, int repeat, int64_t &checksum)
+    {
+        vector<RangeAggregates<int64_t>> results(queries.size());
+        double best = 0;
+        for (int rep = 0; rep < repeat; rep++)
+        {
+            auto start = Clock::now();
+            arr.range_queries(queries.data(), queries.size(), results.data());
+            double seconds = chrono::duration<double>(Clock::now() - start).count();
+            best = rep == 0 ? seconds : min(best, seconds);
+        }
+        checksum = 0;
+        for (const RangeAggregates<int64_t> &result : results)
+        {
+            checksum += result.sum ^ result.xor_value;
+        }
+        return best / queries.size();
+    }
+
+    /**
+     * @brief Reports size and random query time of CompressedPrefixArray against PrefixArray.
+     */
+    void compare_compressed(const char *name, const vector<int> &data, const vector<RangeQuery> &queries, int repeat)
+    {
+        auto start = Clock::now();
+        CompressedPrefixArray<int> compressed(data);
+        double build = chrono::duration<double>(Clock::now() - start).count();
+        PrefixArray<int> plain(data);
+
+        int64_t expected = 0, checksum = 0;
+        double plain_ns = time_queries(plain, queries, repeat, expected) * 1e9;
+        double compressed_ns = time_queries(compressed, queries, repeat, checksum) * 1e9;
+        printf("%-6s %8.1f MB -> %8.1f MB ratio %5.2f %6.2f bits/position (sum+xor) build %8.3f ms "
+               "query %6.2f ns vs %6.2f ns %s\n",
+               name, compressed.uncompressed_bytes() / 1e6, compressed.memory_bytes() / 1e6,
+               compressed.compression_ratio(), compressed.bits_per_value(), build * 1e3, compressed_ns, plain_ns,
+               checksum == expected ? "ok" : "MISMATCH");
+    }
+
+    /**
+     * @brief Compares the compressed and plain prefix arrays on the benchmark data and on a
+     *        random walk derived from it, which behaves like a smooth time series.
+     */
+    void compression(const vector<int> &in, int repeat)
+    {
+        vector<int> walk(in.size());
+        int value = 0;
+        for (size_t i = 0; i < in.size(); i++)
+        {
+            value += in[i] % 64;
+            walk[i] = value;
+        }
+
+        vector<RangeQuery> queries(1000000);
+        mt19937_64 rng(11);
+        for (RangeQuery &q : queries)
+        {
+            q.l = rng() % in.size();
+            q.r = q.l + rng() % (in.size() - q.l);
+        }
+
+        printf("\ncompressed prefix arrays (block %zu) vs PrefixArray\n", CompressedPrefixArray<int>::BLOCK);
+        compare_compressed("random", in, queries, repeat);
+        compare_compressed("walk", walk, queries, repeat);
+    }
+
+    /**
+     * @brief Best time per query of repeat runs of arr.query() over queries.
+     */
+    template <typename Array>
+    double time_min_queries(const Array &arr, const vector<RangeQuery> &queries, int repeat, int64_t &checksum)
+    {
+        double best = 0;
+        for (int rep = 0; rep < repeat; rep++)
+        {
+            checksum = 0;
+            auto start = Clock::now();
+            for (const RangeQuery &q : queries)
+            {
+                checksum += arr.query(q.l, q.r);
+            }
+            double seconds = chrono::duration<double>(Clock::now() - start).count();
+            best = rep == 0 ? seconds : min(best, seconds);
+        }
+        return best / queries.size();
+    }
+
+    /**
+     * @brief Compares every range of data answered by SparseTable (scalar and SIMD build) and
+     *        BlockSparseTable with a running combination from the left end.
+     */
+    template <typename Op>
+    bool check_all_ranges(const vector<int> &data)
+    {
+        SparseTable<int, int, Op> scalar(data, ScanKernel::Scalar), simd(data);
+        BlockSparseTable<int, int, Op> blocked(data);
+        bool ok = true;
+        for (size_t l = 0; l < data.size(); l++)
+        {
+            int expected = Op::identity();
+            for (size_t r = l; r < data.size(); r++)
+            {
+                expected = Op::combine(expected, data[r]);
+                ok = ok && scalar.query(l, r) == expected && simd.query(l, r) == expected &&
+                     blocked.query(l, r) == expected;
+            }
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Range-minimum structures: sparse table build with the scalar and SIMD level
+     *        kernels, then query time against the block variant and a segment tree, for random
+     *        ranges and for ranges of at most 32 elements.
+     *
+     * Runs on at most 2^24 elements, since the full sparse table needs n log n values.
+     */
+    void range_min(const vector<int> &in, int repeat)
+    {
+        vector<int> data(in.begin(), in.begin() + min<size_t>(in.size(), 1 << 24));
+        size_t n = data.size();
+        printf("\nrange minimum over %zu elements\n", n);
+
+        for (ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::Auto})
+        {
+            double best = 0;
+            size_t bytes = 0;
+            for (int rep = 0; rep < repeat; rep++)
+            {
+                auto start = Clock::now();
+                SparseTable<int> table(data, kernel);
+                double seconds = chrono::duration<double>(Clock::now() - start).count();
+                best = rep == 0 ? seconds : min(best, seconds);
+                bytes = table.memory_bytes();
+            }
+            printf("sparse table build %-7s %10.3f ms %8.1f MB\n",
+                   kernel_name(kernel == ScanKernel::Auto ? best_scan_kernel() : kernel), best * 1e3, bytes / 1e6);
+        }
+
+        auto start = Clock::now();
+        BlockSparseTable<int> blocked(data);
+        double build = chrono::duration<double>(Clock::now() - start).count();
+        printf("block sparse table build %10.3f ms %8.1f MB\n", build * 1e3, blocked.memory_bytes() / 1e6);
+
+        SparseTable<int> table(data);
+        SegmentTree<int, int, MinOp<int>> tree(data);
+        mt19937_64 rng(13);
+        for (size_t longest : {n, (size_t)32})
+        {
+            vector<RangeQuery> queries(1000000);
+            for (RangeQuery &q : queries)
+            {
+                q.l = rng() % n;
+                q.r = q.l + rng() % min<size_t>(n - q.l, longest);
+            }
+            int64_t expected = 0, checksum = 0, tree_checksum = 0;
+            double table_ns = time_min_queries(table, queries, repeat, expected) * 1e9;
+            double blocked_ns = time_min_queries(blocked, queries, repeat, checksum) * 1e9;
+            double tree_ns = time_min_queries(tree, queries, repeat, tree_checksum) * 1e9;
+            printf("ranges up to %-10zu sparse %6.2f ns block %6.2f ns segment tree %6.2f ns %s\n", longest,
+                   table_ns, blocked_ns, tree_ns, checksum == expected && tree_checksum == expected ? "ok" : "MISMATCH");
+        }
+
+        // Multiples of 6 with zeros and INT_MIN mixed in, so gcd answers are not all 1 and
+        // single elements exercise the sign handling; not a multiple of BLOCK long.
+        vector<int> small(min<size_t>(n, 3001));
+        for (size_t i = 0; i < small.size(); i++)
+        {
+            small[i] = i % 97 == 0 ? numeric_limits<int>::min() : i % 89 == 0 ? 0 : data[i] % 200 * 6;
+        }
+        printf("all %zu-element ranges against brute force: min %s max %s gcd %s\n", small.size(),
+               check_all_ranges<MinOp<int>>(small) ? "ok" : "MISMATCH",
+               check_all_ranges<MaxOp<int>>(small) ? "ok" : "MISMATCH",
+               check_all_ranges<GcdOp<int>>(small) ? "ok" : "MISMATCH");
+    }
+
+    /**
+     * @brief Point and batch updates of UpdatablePrefixArray and a sum SegmentTree, checked
+     *        against a PrefixArray rebuilt from the updated data.
+     *
+     * Batches of 64 take the one-by-one path of the Fenwick trees, batches of n / 4 (with
+     * repeated indices, so later entries must win) take the unbuild / rebuild path.
+     */
+    void updates(const vector<int> &in)
+    {
+        vector<int> data(in.begin(), in.begin() + min<size_t>(in.size(), 1 << 22));
+        size_t n = data.size();
+        printf("\nupdates over %zu elements\n", n);
+
+        UpdatablePrefixArray<int> updatable(data);
+        SegmentTree<int, int64_t, SumOp<int64_t>> tree(data);
+        mt19937_64 rng(19);
+
+        const size_t points = 100000;
+        vector<pair<long long, int>> assignments(points);
+        for (auto &a : assignments)
+        {
+            a = {(long long)(rng() % n), (int)rng()};
+        }
+        auto start = Clock::now();
+        for (const auto &a : assignments)
+        {
+            updatable.update(a.first, a.second);
+        }
+        auto middle = Clock::now();
+        for (const auto &a : assignments)
+        {
+            tree.update(a.first, a.second);
+        }
+        auto end = Clock::now();
+        for (const auto &a : assignments)
+        {
+            data[a.first] = a.second;
+        }
+        printf("point updates   updatable %8.2f ns/update segment tree %8.2f ns/update\n",
+               chrono::duration<double>(middle - start).count() * 1e9 / points,
+               chrono::duration<double>(end - middle).count() * 1e9 / points);
+
+        for (size_t size : {(size_t)64, n / 4})
+        {
+            vector<pair<long long, int>> batch(size);
+            for (auto &a : batch)
+            {
+                a = {(long long)(rng() % n), (int)rng()};
+            }
+            start = Clock::now();
+            updatable.update_batch(batch);
+            middle = Clock::now();
+            tree.update_batch(batch);
+            end = Clock::now();
+            for (const auto &a : batch)
+            {
+                data[a.first] = a.second;
+            }
+            printf("batch of %-7zu updatable %8.2f ns/update segment tree %8.2f ns/update\n", size,
+                   chrono::duration<double>(middle - start).count() * 1e9 / size,
+                   chrono::duration<double>(end - middle).count() * 1e9 / size);
+        }
+
+        start = Clock::now();
+        PrefixArray<int> rebuilt(data);
+        double rebuild = chrono::duration<double>(Clock::now() - start).count();
+        bool ok = true;
+        for (size_t q = 0; q < 1000000; q++)
+        {
+            long long l = rng() % n, r = l + rng() % (n - l);
+            int64_t sum = rebuilt.range_sum_query(l, r);
+            ok = ok && updatable.range_sum_query(l, r) == sum && tree.query(l, r) == sum &&
+                 updatable.range_xor_query(l, r) == rebuilt.range_xor_query(l, r);
+        }
+        printf("PrefixArray rebuild %10.3f ms, queries after updates %s\n", rebuild * 1e3, ok ? "ok" : "MISMATCH");
+    }
+
+    /**
+     * @brief Append throughput of the streaming structures, one sample at a time and in
+     *        batches, and the cost of a sliding-window query.
+     */
+    void streaming(const vector<int> &in, int repeat)
+    {
+        size_t n = in.size();
+        const size_t batch = 4096, window = 1 << 16;
+        printf("\nstreaming appends of %zu samples\n", n);
+
+        double single = 0, batched = 0, ring = 0;
+        for (int rep = 0; rep < repeat; rep++)
+        {
+            AppendablePrefixArray<int> one, many;
+            SlidingWindowPrefixArray<int> windowed(window);
+            auto start = Clock::now();
+            for (size_t i = 0; i < n; i++)
+            {
+                one.append(in[i]);
+            }
+            auto middle = Clock::now();
+            for (size_t i = 0; i < n; i += batch)
+            {
+                many.append(in.data() + i, min(batch, n - i));
+            }
+            auto end = Clock::now();
+            for (size_t i = 0; i < n; i++)
+            {
+                windowed.append(in[i]);
+            }
+            auto last = Clock::now();
+            double times[3] = {chrono::duration<double>(middle - start).count(),
+                               chrono::duration<double>(end - middle).count(),
+                               chrono::duration<double>(last - end).count()};
+            single = rep == 0 ? times[0] : min(single, times[0]);
+            batched = rep == 0 ? times[1] : min(batched, times[1]);
+            ring = rep == 0 ? times[2] : min(ring, times[2]);
+        }
+        printf("append one at a time %8.3f ns/sample, batches of %zu %8.3f ns/sample, ring of %zu %8.3f ns/sample\n",
+               single * 1e9 / n, batch, batched * 1e9 / n, window, ring * 1e9 / n);
+
+        SlidingWindowPrefixArray<int> windowed(window);
+        windowed.append(in.data(), n);
+        const size_t queries = 1000000;
+        mt19937_64 rng(17);
+        vector<long long> counts(queries);
+        for (long long &count : counts)
+        {
+            count = 1 + rng() % min(n, window);
+        }
+        int64_t checksum = 0;
+        auto start = Clock::now();
+        for (long long count : counts)
+        {
+            RangeAggregates<int64_t> result = windowed.window_query(count);
+            checksum += result.sum ^ result.xor_value;
+        }
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        // Both structures against PrefixArray: window queries, random ranges on the appendable
+        // array, and ranges the ring still holds on the sliding window.
+        PrefixArray<int> reference(in);
+        AppendablePrefixArray<int> appended;
+        for (size_t i = 0; i < n;)
+        {
+            // Runs of single appends and batches of batch + 1, so both paths cross chunk ends.
+            size_t step = i / 1000 % 2 == 0 ? 1 : min(batch + 1, n - i);
+            if (step == 1)
+            {
+                appended.append(in[i]);
+            }
+            else
+            {
+                appended.append(in.data() + i, step);
+            }
+            i += step;
+        }
+        int64_t expected = 0;
+        bool ok = appended.size() == (long long)n;
+        for (long long count : counts)
+        {
+            RangeAggregates<int64_t> result = {reference.range_sum_query(n - count, n - 1),
+                                               reference.range_xor_query(n - count, n - 1)};
+            RangeAggregates<int64_t> from_appended = appended.window_query(count);
+            expected += result.sum ^ result.xor_value;
+            ok = ok && from_appended.sum == result.sum && from_appended.xor_value == result.xor_value;
+        }
+        vector<RangeQuery> ranges(queries), held(queries);
+        for (size_t q = 0; q < queries; q++)
+        {
+            ranges[q].l = rng() % n;
+            ranges[q].r = ranges[q].l + rng() % (n - ranges[q].l);
+            held[q].l = windowed.oldest() + rng() % (n - windowed.oldest());
+            held[q].r = held[q].l + rng() % (n - held[q].l);
+        }
+        vector<RangeAggregates<int64_t>> results(queries), reference_results(queries);
+        auto matches = [&](const vector<RangeQuery> &batch, size_t answered)
+        {
+            reference.range_queries(batch.data(), queries, reference_results.data());
+            bool same = answered == queries;
+            for (size_t q = 0; q < queries; q++)
+            {
+                same = same && results[q].sum == reference_results[q].sum &&
+                       results[q].xor_value == reference_results[q].xor_value;
+            }
+            return same;
+        };
+        ok = ok && matches(ranges, appended.range_queries(ranges.data(), queries, results.data()));
+        ok = ok && matches(held, windowed.range_queries(held.data(), queries, results.data()));
+        printf("sliding-window query %8.2f ns/query (checksum %lld), answers against PrefixArray %s\n",
+               seconds * 1e9 / queries, (long long)checksum, ok && checksum == expected ? "ok" : "MISMATCH");
+    }
+
+    /**
+     * @brief One writer appends while reader threads query both streaming structures, checking
+     *        every answer.
+     *
+     * The stream repeats the first PERIOD input values, so a window of k * PERIOD samples has
+     * a closed-form sum and xor wherever the writer is; ranges are checked against a
+     * PrefixArray over the whole stream, since published samples never change. Evicted or
+     * not yet published ranges must come back as invalid_query().
+     */
+    void concurrent_streaming(const vector<int> &in)
+    {
+        const size_t PERIOD = 64, window = 1 << 12;
+        size_t n = min<size_t>(in.size(), 1 << 22) / PERIOD * PERIOD;
+        if (n == 0)
+        {
+            return;
+        }
+        vector<int> stream(n);
+        int64_t period_sum = 0, period_xor = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            stream[i] = in[i % PERIOD];
+        }
+        for (size_t i = 0; i < PERIOD; i++)
+        {
+            period_sum += stream[i];
+            period_xor ^= stream[i];
+        }
+        PrefixArray<int> reference(stream);
+
+        unsigned readers = max(2u, thread::hardware_concurrency());
+        printf("\nconcurrent streaming: 1 writer, %u readers, %zu samples\n", readers, n);
+        AppendablePrefixArray<int> appended;
+        SlidingWindowPrefixArray<int> windowed(window);
+        atomic<bool> done(false), ok(true);
+        atomic<long long> checks(0);
+
+        auto reader = [&](unsigned t)
+        {
+            mt19937_64 rng(23 + t);
+            long long local = 0;
+            bool good = true;
+            while (!done.load(memory_order_acquire))
+            {
+                long long published = appended.size();
+                if (published > 0)
+                {
+                    long long l = rng() % published, r = l + rng() % (published - l);
+                    good = good && appended.range_sum_query(l, r) == reference.range_sum_query(l, r) &&
+                           appended.range_xor_query(l, r) == reference.range_xor_query(l, r);
+                }
+                good = good && appended.range_sum_query(0, n) == appended.invalid_query();
+
+                long long periods = 1 + rng() % (window / PERIOD);
+                for (RangeAggregates<int64_t> result :
+                     {appended.window_query(periods * PERIOD), windowed.window_query(periods * PERIOD)})
+                {
+                    bool invalid = result.sum == appended.invalid_query() && result.xor_value == appended.invalid_query();
+                    good = good && (invalid || (result.sum == periods * period_sum &&
+                                                result.xor_value == (periods % 2 ? period_xor : 0)));
+                }
+
+                long long oldest = windowed.oldest(), end = windowed.size();
+                if (end > oldest)
+                {
+                    long long l = oldest + rng() % (end - oldest), r = l + rng() % (end - l);
+                    int64_t sum = windowed.range_sum_query(l, r);
+                    good = good && (sum == windowed.invalid_query() || sum == reference.range_sum_query(l, r));
+                }
+                local++;
+            }
+            checks += local;
+            if (!good)
+            {
+                ok = false;
+            }
+        };
+
+        vector<thread> threads;
+        for (unsigned t = 0; t < readers; t++)
+        {
+            threads.emplace_back(reader, t);
+        }
+        mt19937_64 rng(29);
+        for (size_t i = 0; i < n;)
+        {
+            size_t step = rng() % 4 == 0 ? min<size_t>(1 + rng() % 10000, n - i) : 1;
+            if (step == 1)
+            {
+                appended.append(stream[i]);
+            }
+            else
+            {
+                appended.append(stream.data() + i, step);
+            }
+            windowed.append(stream.data() + i, step);
+            i += step;
+        }
+        done.store(true, memory_order_release);
+        for (thread &t : threads)
+        {
+            t.join();
+        }
+        printf("%lld checks while appending %s\n", (long long)checks, ok ? "ok" : "MISMATCH");
+    }
+}
+
+/**
+ * @brief Benchmarks the scalar, SSE4.1 and AVX2 prefix-scan kernels on int data with
+ *        64-bit accumulators.
+ *
+ * Usage: prefix_bench [elements] [repeat] [pin]. 10^9 elements need about 12 GB of memory
+ * (4 GB input, 8 GB output). The scaling section then runs the blocked parallel scan on
+ * 1, 2, 4, ... threads; pass "pin" to pin thread t to CPU t. Finally a summed-area table is
+ * built over a square grid of the same data and queried with random rectangles. Last,
+ * CompressedPrefixArray is compared with PrefixArray for size and random query time, and
+ * the range-minimum, updatable and streaming structures are timed and checked, the
+ * streaming ones also while a writer appends concurrently.
+ */
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? stoull(argv[1]) : 100000000;
+    int repeat = argc > 2 ? atoi(argv[2]) : 3;
+    bool pin = argc > 3 && string(argv[3]) == "pin";
+
+    vector<int> in(n);
+    mt19937 rng(12345);
+    for (size_t i = 0; i < n; i++)
+    {
+        in[i] = (int)rng();
+    }
+
+    printf("elements: %zu, best of %d runs, auto kernel: %s\n", n, repeat, kernel_name(best_scan_kernel()));
+    run<SumOp<int64_t>>("sum", in, repeat);
+    run<XorOp<int64_t>>("xor", in, repeat);
+    scaling(in, repeat, pin);
+    grid(in, repeat);
+    compression(in, repeat);
+    range_min(in, repeat);
+    updates(in);
+    streaming(in, repeat);
+    concurrent_streaming(in);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#ifndef PREFIX_OPS_H
+#define PREFIX_OPS_H
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+/**
+ * @brief Associative operators that prefix structures are built over.
+ *
+ * An operator is a struct with static members:
+ *   - identity()               the neutral element,
+ *   - combine(a, b)            the associative operation a . b,
+ *   - subtract(total, prefix)  for invertible operators, the x with combine(prefix, x) == total,
+ *                              which turns two prefix values into a range value.
+ *
+ * User-defined operators follow the same shape, e.g. multiplication modulo a prime with
+ * subtract() multiplying by the modular inverse. Operators without subtract() are monoids
+ * and only work with structures that never invert, such as SegmentTree.
+ */
+
+/**
+ * @brief Addition; invertible through subtraction.
+ */
+template <typename Acc>
+struct SumOp
+{
+    static Acc identity() { return Acc(0); }
+    static Acc combine(const Acc &a, const Acc &b) { return a + b; }
+    static Acc subtract(const Acc &total, const Acc &prefix) { return total - prefix; }
+};
+
+/**
+ * @brief Bitwise xor; its own inverse.
+ */
+template <typename Acc>
+struct XorOp
+{
+    static_assert(std::is_integral<Acc>::value, "XorOp requires an integral accumulator");
+
+    static Acc identity() { return Acc(0); }
+    static Acc combine(const Acc &a, const Acc &b) { return a ^ b; }
+    static Acc subtract(const Acc &total, const Acc &prefix) { return total ^ prefix; }
+};
+
+/**
+ * @brief Minimum; a monoid without inverse, usable with SegmentTree but not PrefixScan.
+ */
+template <typename Acc>
+struct MinOp
+{
+    static Acc identity() { return std::numeric_limits<Acc>::max(); }
+    static Acc combine(const Acc &a, const Acc &b) { return b < a ? b : a; }
+};
+
+/**
+ * @brief Maximum; a monoid without inverse, usable with SegmentTree but not PrefixScan.
+ */
+template <typename Acc>
+struct MaxOp
+{
+    static Acc identity() { return std::numeric_limits<Acc>::lowest(); }
+    static Acc combine(const Acc &a, const Acc &b) { return a < b ? b : a; }
+};
+
+/**
+ * @brief Greatest common divisor of the absolute values; a monoid without inverse, with
+ *        gcd(0, x) = |x| as identity.
+ *
+ * The gcd is taken on the unsigned magnitudes, so numeric_limits<Acc>::min() is valid input
+ * (std::gcd would be undefined for it). Its magnitude 2^(w - 1) does not fit Acc and wraps
+ * back to min(), which is the only result that does: gcd(min(), 0) == min(). A signed
+ * range whose elements are all min() or 0, with at least one min(), therefore yields the
+ * negative value min(); every other result is non-negative. Use an unsigned or wider
+ * accumulator to get 2^(w - 1) instead.
+ */
+template <typename Acc>
+struct GcdOp
+{
+    static_assert(std::is_integral<Acc>::value, "GcdOp requires an integral accumulator");
+
+    typedef typename std::make_unsigned<Acc>::type UAcc;
+
+    static UAcc magnitude(const Acc &x) { return x < 0 ? UAcc(0) - UAcc(x) : UAcc(x); }
+
+    static Acc identity() { return Acc(0); }
+    static Acc combine(const Acc &a, const Acc &b) { return Acc(std::gcd(magnitude(a), magnitude(b))); }
+};
+
+/**
+ * @brief True for operators with combine(a, a) == a. Overlapping ranges may then be combined,
+ *        which is what lets SparseTable answer a query from two overlapping blocks.
+ *        Specialise for user-defined idempotent operators.
+ */
+template <typename Op>
+struct is_idempotent : std::false_type
+{
+};
+
+template <typename Acc>
+struct is_idempotent<MinOp<Acc>> : std::true_type
+{
+};
+
+template <typename Acc>
+struct is_idempotent<MaxOp<Acc>> : std::true_type
+{
+};
+
+template <typename Acc>
+struct is_idempotent<GcdOp<Acc>> : std::true_type
+{
+};
+
+/**
+ * @brief Default accumulator for element type T: integers of up to 32 bits are widened to
+ *        64 bits so that sums of up to 2^31 elements cannot overflow; floating point
+ *        elements accumulate in double.
+ */
+template <typename T, typename Enable = void>
+struct wide_accumulator
+{
+    typedef T type;
+};
+
+template <typename T>
+struct wide_accumulator<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    typedef typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type type;
+};
+
+template <typename T>
+struct wide_accumulator<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    typedef typename std::conditional<(sizeof(T) > sizeof(double)), T, double>::type type;
+};
+
+template <typename T>
+using wide_accumulator_t = typename wide_accumulator<T>::type;
+
+#endif // PREFIX_OPS_H
@@ -0,0 +1,180 @@
+#ifndef PREFIX_SCAN_H
+#define PREFIX_SCAN_H
+
+#include "prefix_ops.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define PREFIX_SCAN_X86 1
+#endif
+
+/**
+ * @brief Prefix-scan kernels; Auto picks the widest one the CPU supports.
+ */
+enum class ScanKernel
+{
+    Auto,
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+namespace prefix_detail
+{
+    /**
+     * @brief True if the SIMD kernels handle this combination: 32/64-bit integer elements
+     *        scanned into a 64-bit integer accumulator with SumOp or XorOp.
+     */
+    template <typename T, typename Acc, typename Op>
+    struct simd_scannable
+    {
+        static const bool value = std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8) &&
+                                  std::is_integral<Acc>::value && sizeof(Acc) == 8 &&
+                                  (std::is_same<Op, SumOp<Acc>>::value || std::is_same<Op, XorOp<Acc>>::value);
+    };
+
+    template <typename T, typename Acc, typename Op>
+    Acc scan_scalar(const T *in, Acc *out, size_t n, Acc carry)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            carry = Op::combine(carry, Acc(in[i]));
+            out[i] = carry;
+        }
+        return carry;
+    }
+
+#ifdef PREFIX_SCAN_X86
+    // The kernels work on the 64-bit lane bit patterns; addition and xor are the same for
+    // signed and unsigned accumulators. 32-bit elements are sign- or zero-extended first.
+
+    template <bool IsXor>
+    __attribute__((target("sse4.1"))) inline __m128i combine_sse(__m128i a, __m128i b)
+    {
+        return IsXor ? _mm_xor_si128(a, b) : _mm_add_epi64(a, b);
+    }
+
+    template <typename T>
+    __attribute__((target("sse4.1"))) inline __m128i load2_sse(const T *in)
+    {
+        if (sizeof(T) == 8)
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+        return std::is_signed<T>::value ? _mm_cvtepi32_epi64(v) : _mm_cvtepu32_epi64(v);
+    }
+
+    template <bool IsXor, typename T, typename Acc>
+    __attribute__((target("sse4.1"))) Acc scan_sse41(const T *in, Acc *out, size_t n, Acc carry)
+    {
+        __m128i c = _mm_set1_epi64x((long long)carry);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128i x = load2_sse(in + i);
+            x = combine_sse<IsXor>(x, _mm_slli_si128(x, 8)); // [a, a.b]
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), combine_sse<IsXor>(x, c));
+            c = combine_sse<IsXor>(c, _mm_unpackhi_epi64(x, x));
+        }
+        carry = (Acc)_mm_cvtsi128_si64(c);
+        typedef typename std::conditional<IsXor, XorOp<Acc>, SumOp<Acc>>::type Op;
+        return scan_scalar<T, Acc, Op>(in + i, out + i, n - i, carry);
+    }
+
+    template <bool IsXor>
+    __attribute__((target("avx2"))) inline __m256i combine_avx2(__m256i a, __m256i b)
+    {
+        return IsXor ? _mm256_xor_si256(a, b) : _mm256_add_epi64(a, b);
+    }
+
+    template <typename T>
+    __attribute__((target("avx2"))) inline __m256i load4_avx2(const T *in)
+    {
+        if (sizeof(T) == 8)
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        return std::is_signed<T>::value ? _mm256_cvtepi32_epi64(v) : _mm256_cvtepu32_epi64(v);
+    }
+
+    template <bool IsXor, typename T, typename Acc>
+    __attribute__((target("avx2"))) Acc scan_avx2(const T *in, Acc *out, size_t n, Acc carry)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i c = _mm256_set1_epi64x((long long)carry);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i x = load4_avx2(in + i);
+            // Shift by one lane, then by two lanes, across the 128-bit halves.
+            __m256i s1 = _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03);
+            x = combine_avx2<IsXor>(x, s1);
+            __m256i s2 = _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F);
+            x = combine_avx2<IsXor>(x, s2);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), combine_avx2<IsXor>(x, c));
+            // Only this single combine sits on the loop-carried dependency chain.
+            c = combine_avx2<IsXor>(c, _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3)));
+        }
+        carry = (Acc)_mm256_extract_epi64(c, 0);
+        typedef typename std::conditional<IsXor, XorOp<Acc>, SumOp<Acc>>::type Op;
+        return scan_scalar<T, Acc, Op>(in + i, out + i, n - i, carry);
+    }
+#endif
+}
+
+/**
+ * @brief Returns the kernel that ScanKernel::Auto resolves to on this CPU.
+ */
+inline ScanKernel best_scan_kernel()
+{
+#ifdef PREFIX_SCAN_X86
+    static const ScanKernel best = __builtin_cpu_supports("avx2")     ? ScanKernel::AVX2
+                                   : __builtin_cpu_supports("sse4.1") ? ScanKernel::SSE41
+                                                                      : ScanKernel::Scalar;
+    return best;
+#else
+    return ScanKernel::Scalar;
+#endif
+}
+
+/**
+ * @brief Inclusive prefix scan: out[i] = carry . in[0] . ... . in[i].
+ *
+ * Uses an in-register SSE4.1/AVX2 scan for 32/64-bit integers with SumOp or XorOp on
+ * x86-64 and the scalar loop everywhere else. in and out may not overlap.
+ *
+ * @param in Input elements.
+ * @param out Output prefix values.
+ * @param n Number of elements.
+ * @param carry Value combined in front of the first element (e.g. the previous block total).
+ * @param kernel Kernel to use; unsupported choices fall back to the scalar loop.
+ * @return Acc The last prefix value (carry if n is 0).
+ */
+template <typename T, typename Acc, typename Op>
+Acc prefix_scan(const T *in, Acc *out, size_t n, Acc carry = Op::identity(), ScanKernel kernel = ScanKernel::Auto)
+{
+    if (kernel == ScanKernel::Auto)
+    {
+        kernel = best_scan_kernel();
+    }
+#ifdef PREFIX_SCAN_X86
+    if constexpr (prefix_detail::simd_scannable<T, Acc, Op>::value)
+    {
+        const bool is_xor = std::is_same<Op, XorOp<Acc>>::value;
+        if (kernel == ScanKernel::AVX2 && best_scan_kernel() == ScanKernel::AVX2)
+        {
+            return is_xor ? prefix_detail::scan_avx2<true>(in, out, n, carry)
+                          : prefix_detail::scan_avx2<false>(in, out, n, carry);
+        }
+        if (kernel != ScanKernel::Scalar && best_scan_kernel() != ScanKernel::Scalar)
+        {
+            return is_xor ? prefix_detail::scan_sse41<true>(in, out, n, carry)
+                          : prefix_detail::scan_sse41<false>(in, out, n, carry);
+        }
+    }
+#endif
+    return prefix_detail::scan_scalar<T, Acc, Op>(in, out, n, carry);
+}
+
+#endif // PREFIX_SCAN_H
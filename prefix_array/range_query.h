@@ -0,0 +1,109 @@
+#ifndef RANGE_QUERY_H
+#define RANGE_QUERY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Conventions shared by the range-query structures in this directory.
+ *
+ * Ranges are inclusive [l, r] with 0 <= l <= r < n. Out-of-bounds queries do not throw;
+ * they return invalid_query_value<Acc>(), see there. The sentinel is an ordinary value of
+ * Acc and can equal a genuine answer, so callers that must tell the two apart check
+ * valid_range() first, or use the in-bounds count returned by range_queries().
+ */
+
+/**
+ * @brief One inclusive range [l, r] of a query batch.
+ */
+struct RangeQuery
+{
+    long long l;
+    long long r;
+};
+
+inline bool valid_range(long long l, long long r, long long n)
+{
+    return l >= 0 && l <= r && r < n;
+}
+
+/**
+ * @brief Result of an out-of-bounds query: the lowest value of a signed or floating point
+ *        Acc (INT64_MIN for the default accumulator of int elements), and the largest value
+ *        of an unsigned Acc, whose lowest value 0 is the answer to every all-zero range.
+ */
+template <typename Acc>
+Acc invalid_query_value()
+{
+    return numeric_limits<Acc>::is_signed ? numeric_limits<Acc>::lowest() : numeric_limits<Acc>::max();
+}
+
+/**
+ * @brief Order in which to answer a query batch.
+ *
+ * With sort_queries, queries are visited by increasing l (then r), so consecutive queries
+ * read nearby prefix values; this pays off once the structure is much larger than the cache.
+ * Otherwise the batch is answered in input order.
+ */
+inline vector<size_t> query_order(const RangeQuery *queries, size_t count, bool sort_queries)
+{
+    vector<size_t> order(count);
+    iota(order.begin(), order.end(), size_t(0));
+    if (sort_queries)
+    {
+        sort(order.begin(), order.end(), [queries](size_t a, size_t b)
+             { return queries[a].l != queries[b].l ? queries[a].l < queries[b].l : queries[a].r < queries[b].r; });
+    }
+    return order;
+}
+
+/**
+ * @brief Answers a query batch over n elements: range(l, r) computes the result of one
+ *        in-bounds range, out-of-bounds queries get invalid.
+ *
+ * The batch loop shared by the range-query structures, which differ only in range().
+ *
+ * @param sort_queries Answer in increasing l order, see query_order(); results stay in
+ *                     input order either way.
+ * @return size_t Number of in-bounds queries.
+ */
+template <typename Result, typename Range>
+size_t answer_range_queries(long long n, const RangeQuery *queries, size_t count, Result *results,
+                            const Result &invalid, bool sort_queries, Range range)
+{
+    size_t valid = 0;
+    auto answer = [&](size_t i)
+    {
+        long long l = queries[i].l, r = queries[i].r;
+        if (!valid_range(l, r, n))
+        {
+            results[i] = invalid;
+            return;
+        }
+        results[i] = range(l, r);
+        valid++;
+    };
+
+    if (sort_queries)
+    {
+        for (size_t i : query_order(queries, count, true))
+        {
+            answer(i);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            answer(i);
+        }
+    }
+    return valid;
+}
+
+#endif // RANGE_QUERY_H
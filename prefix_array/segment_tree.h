@@ -0,0 +1,160 @@
+#ifndef SEGMENT_TREE_H
+#define SEGMENT_TREE_H
+
+#include "prefix_ops.h"
+#include "range_query.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Bottom-up (iterative) segment tree over any monoid: O(log n) point updates and
+ *        range queries.
+ *
+ * The tree is a flat array of 2n nodes: leaves at [n, 2n), node i combines 2i and 2i + 1.
+ * There are no pointers and no recursion, and a query walks up from both ends of the range,
+ * touching O(log n) nodes that are mostly adjacent in memory. Left and right partial
+ * results are kept apart, so the operator does not have to be commutative.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ * @tparam Op Associative operator with identity() and combine(), see prefix_ops.h.
+ */
+template <typename T, typename Acc = wide_accumulator_t<T>, typename Op = SumOp<Acc>>
+class SegmentTree
+{
+private:
+    size_t N;
+    vector<Acc> tree;
+
+    void _pull(size_t node)
+    {
+        this->tree[node] = Op::combine(this->tree[2 * node], this->tree[2 * node + 1]);
+    }
+
+public:
+    /**
+     * @brief O(n) construction: leaves are copied, then every internal node is combined once.
+     */
+    explicit SegmentTree(const vector<T> &arr) : N(arr.size()), tree(2 * arr.size(), Op::identity())
+    {
+        for (size_t i = 0; i < this->N; i++)
+        {
+            this->tree[this->N + i] = Acc(arr[i]);
+        }
+        for (size_t node = this->N; node-- > 1;)
+        {
+            this->_pull(node);
+        }
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    bool valid_range(long long l, long long r) const
+    {
+        return ::valid_range(l, r, this->N);
+    }
+
+    /**
+     * @brief Combination of arr[l..r] in order, or invalid_query() if the range is out of bounds.
+     */
+    Acc query(long long l, long long r) const
+    {
+        if (!this->valid_range(l, r))
+        {
+            return invalid_query();
+        }
+        Acc left = Op::identity(), right = Op::identity();
+        for (size_t lo = l + this->N, hi = r + 1 + this->N; lo < hi; lo >>= 1, hi >>= 1)
+        {
+            if (lo & 1)
+            {
+                left = Op::combine(left, this->tree[lo++]);
+            }
+            if (hi & 1)
+            {
+                right = Op::combine(this->tree[--hi], right);
+            }
+        }
+        return Op::combine(left, right);
+    }
+
+    /**
+     * @brief Sets arr[i] to value.
+     *
+     * @return bool False if i is out of bounds.
+     */
+    bool update(long long i, const T &value)
+    {
+        if (i < 0 || i >= (long long)this->N)
+        {
+            return false;
+        }
+        size_t node = i + this->N;
+        this->tree[node] = Acc(value);
+        for (node >>= 1; node >= 1; node >>= 1)
+        {
+            this->_pull(node);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Applies a batch of (index, value) assignments; later entries win.
+     *
+     * All leaves are written first, then the touched ancestors are recomputed in decreasing
+     * node order. Children always have larger indices than their parent, so every node is
+     * pulled once, after both of its children are final, whichever level its leaves sit on.
+     * k updates cost O(k log(n / k)) combines rather than O(k log n), plus O(log k) heap
+     * work per touched node.
+     *
+     * @return size_t Number of in-bounds assignments applied.
+     */
+    size_t update_batch(const vector<pair<long long, T>> &updates)
+    {
+        vector<size_t> dirty;
+        dirty.reserve(updates.size());
+        for (const auto &u : updates)
+        {
+            if (u.first >= 0 && u.first < (long long)this->N)
+            {
+                this->tree[u.first + this->N] = Acc(u.second);
+                dirty.push_back((u.first + this->N) >> 1);
+            }
+        }
+        size_t applied = dirty.size();
+
+        // Max-heap of dirty nodes. Node 0 is unused; with a single element the leaf is the
+        // root and has no parent.
+        make_heap(dirty.begin(), dirty.end());
+        size_t last = 0;
+        while (!dirty.empty())
+        {
+            pop_heap(dirty.begin(), dirty.end());
+            size_t node = dirty.back();
+            dirty.pop_back();
+            if (node == 0 || node == last)
+            {
+                continue;
+            }
+            last = node;
+            this->_pull(node);
+            dirty.push_back(node >> 1);
+            push_heap(dirty.begin(), dirty.end());
+        }
+        return applied;
+    }
+};
+
+#endif // SEGMENT_TREE_H
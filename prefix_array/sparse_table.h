@@ -0,0 +1,333 @@
+#ifndef SPARSE_TABLE_H
+#define SPARSE_TABLE_H
+
+#include "prefix_ops.h"
+#include "prefix_scan.h"
+#include "range_query.h"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+namespace prefix_detail
+{
+    /**
+     * @brief True if the SIMD level kernels handle this combination: MinOp or MaxOp over 32-bit
+     *        integers or signed 64-bit integers.
+     */
+    template <typename Acc, typename Op>
+    struct simd_levelable
+    {
+        static const bool value = std::is_integral<Acc>::value &&
+                                  (sizeof(Acc) == 4 || (sizeof(Acc) == 8 && std::is_signed<Acc>::value)) &&
+                                  (std::is_same<Op, MinOp<Acc>>::value || std::is_same<Op, MaxOp<Acc>>::value);
+    };
+
+    template <typename Acc, typename Op>
+    void combine_scalar(const Acc *a, const Acc *b, Acc *out, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = Op::combine(a[i], b[i]);
+        }
+    }
+
+#ifdef PREFIX_SCAN_X86
+    template <bool IsMax, typename Acc>
+    __attribute__((target("avx2"))) inline __m256i min_max_avx2(__m256i x, __m256i y)
+    {
+        if (sizeof(Acc) == 8)
+        {
+            __m256i greater = _mm256_cmpgt_epi64(x, y);
+            return IsMax ? _mm256_blendv_epi8(y, x, greater) : _mm256_blendv_epi8(x, y, greater);
+        }
+        if (std::is_signed<Acc>::value)
+            return IsMax ? _mm256_max_epi32(x, y) : _mm256_min_epi32(x, y);
+        return IsMax ? _mm256_max_epu32(x, y) : _mm256_min_epu32(x, y);
+    }
+
+    template <bool IsMax, typename Acc, typename Op>
+    __attribute__((target("avx2"))) void combine_avx2(const Acc *a, const Acc *b, Acc *out, size_t n)
+    {
+        const size_t lanes = 32 / sizeof(Acc);
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), min_max_avx2<IsMax, Acc>(x, y));
+        }
+        combine_scalar<Acc, Op>(a + i, b + i, out + i, n - i);
+    }
+#endif
+
+    /**
+     * @brief out[i] = a[i] . b[i]; AVX2 for simd_levelable operators, scalar otherwise.
+     */
+    template <typename Acc, typename Op>
+    void combine_arrays(const Acc *a, const Acc *b, Acc *out, size_t n, ScanKernel kernel)
+    {
+#ifdef PREFIX_SCAN_X86
+        if constexpr (simd_levelable<Acc, Op>::value)
+        {
+            if ((kernel == ScanKernel::Auto || kernel == ScanKernel::AVX2) && best_scan_kernel() == ScanKernel::AVX2)
+            {
+                const bool is_max = std::is_same<Op, MaxOp<Acc>>::value;
+                return combine_avx2<is_max, Acc, Op>(a, b, out, n);
+            }
+        }
+#endif
+        combine_scalar<Acc, Op>(a, b, out, n);
+    }
+
+    inline unsigned floor_log2(unsigned long long x)
+    {
+        return 63 - __builtin_clzll(x);
+    }
+}
+
+/**
+ * @brief Static range queries in O(1) for idempotent operators (min, max, gcd).
+ *
+ * Level k holds the combination of every window of 2^k elements, so any range is covered by
+ * two, possibly overlapping, windows of its largest power-of-two length; overlap is harmless
+ * because combine(a, a) == a. A level is built from the previous one as the element-wise
+ * combination of two shifted copies, which runs through AVX2 min/max when available.
+ *
+ * Memory is n log n accumulators; see BlockSparseTable for linear memory.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type; defaults to T, since min, max and gcd cannot overflow and
+ *             narrow values fill more SIMD lanes.
+ * @tparam Op Idempotent operator, see is_idempotent in prefix_ops.h.
+ */
+template <typename T, typename Acc = T, typename Op = MinOp<Acc>>
+class SparseTable
+{
+    static_assert(is_idempotent<Op>::value, "SparseTable needs an idempotent operator");
+
+private:
+    long long N;
+    vector<Acc> table;
+    vector<size_t> level_start;
+
+    Acc _query(long long l, long long r) const
+    {
+        unsigned k = prefix_detail::floor_log2(r - l + 1);
+        const Acc *level = this->table.data() + this->level_start[k];
+        return Op::combine(level[l], level[r - (1LL << k) + 1]);
+    }
+
+public:
+    /**
+     * @param kernel Build kernel; AVX2 or Auto use AVX2 min/max where supported.
+     */
+    SparseTable(const T *data, size_t n, ScanKernel kernel = ScanKernel::Auto) : N(n)
+    {
+        size_t levels = n == 0 ? 0 : prefix_detail::floor_log2(n) + 1, total = 0;
+        for (size_t k = 0; k < levels; k++)
+        {
+            this->level_start.push_back(total);
+            total += n - (size_t(1) << k) + 1;
+        }
+        this->table.resize(total);
+        for (size_t i = 0; i < n; i++)
+        {
+            this->table[i] = Acc(data[i]);
+        }
+        for (size_t k = 1; k < levels; k++)
+        {
+            const Acc *previous = this->table.data() + this->level_start[k - 1];
+            size_t half = size_t(1) << (k - 1);
+            size_t count = n - (size_t(1) << k) + 1;
+            prefix_detail::combine_arrays<Acc, Op>(previous, previous + half,
+                                                   this->table.data() + this->level_start[k], count, kernel);
+        }
+    }
+
+    explicit SparseTable(const vector<T> &arr, ScanKernel kernel = ScanKernel::Auto)
+        : SparseTable(arr.data(), arr.size(), kernel)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    bool valid_range(long long l, long long r) const
+    {
+        return ::valid_range(l, r, this->N);
+    }
+
+    /**
+     * @brief Combination of arr[l..r], or invalid_query() if the range is out of bounds.
+     */
+    Acc query(long long l, long long r) const
+    {
+        if (!this->valid_range(l, r))
+        {
+            return invalid_query();
+        }
+        return this->_query(l, r);
+    }
+
+    /**
+     * @brief Answers a batch of queries; out-of-bounds queries get invalid_query().
+     *
+     * @param sort_queries Answer in increasing l order for locality, see query_order().
+     * @return size_t Number of in-bounds queries.
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, Acc *results, bool sort_queries = false) const
+    {
+        return answer_range_queries(this->N, queries, count, results, invalid_query(), sort_queries,
+                                    [this](long long l, long long r)
+                                    { return this->_query(l, r); });
+    }
+
+    size_t memory_bytes() const
+    {
+        return this->table.capacity() * sizeof(Acc) + this->level_start.capacity() * sizeof(size_t);
+    }
+};
+
+/**
+ * @brief Static range queries for idempotent operators in linear memory.
+ *
+ * The array is cut into blocks of BLOCK elements. Each element stores the combination from
+ * its block start (prefix) and up to its block end (suffix), and a SparseTable is built
+ * over the n / BLOCK block totals only. A range spanning blocks is suffix[l], the block
+ * table over the blocks strictly inside, and prefix[r]: O(1). A range inside one block is
+ * scanned directly; that is at most BLOCK contiguous elements, one or two cache lines.
+ *
+ * Memory is 3n accumulators plus the block table, (n / BLOCK) log(n / BLOCK).
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type, see SparseTable.
+ * @tparam Op Idempotent operator, see is_idempotent in prefix_ops.h.
+ */
+template <typename T, typename Acc = T, typename Op = MinOp<Acc>>
+class BlockSparseTable
+{
+    static_assert(is_idempotent<Op>::value, "BlockSparseTable needs an idempotent operator");
+
+public:
+    static constexpr size_t BLOCK = 32;
+
+private:
+    long long N;
+    vector<Acc> values;
+    vector<Acc> prefix;
+    vector<Acc> suffix;
+    SparseTable<Acc, Acc, Op> blocks;
+
+    static vector<Acc> _block_totals(const vector<Acc> &suffix)
+    {
+        vector<Acc> totals((suffix.size() + BLOCK - 1) / BLOCK);
+        for (size_t b = 0; b < totals.size(); b++)
+        {
+            totals[b] = suffix[b * BLOCK];
+        }
+        return totals;
+    }
+
+    static vector<Acc> _suffixes(const T *data, size_t n)
+    {
+        vector<Acc> suffix(n);
+        for (size_t i = n; i-- > 0;)
+        {
+            bool block_end = i + 1 == n || (i + 1) % BLOCK == 0;
+            suffix[i] = block_end ? Acc(data[i]) : Op::combine(Acc(data[i]), suffix[i + 1]);
+        }
+        return suffix;
+    }
+
+    Acc _query(long long l, long long r) const
+    {
+        long long first = l / BLOCK, last = r / BLOCK;
+        if (first == last)
+        {
+            // Seeded with the identity so a single element is normalised like every other
+            // answer, e.g. GcdOp returns |x| for [x], as SparseTable does.
+            Acc result = Op::identity();
+            for (long long i = l; i <= r; i++)
+            {
+                result = Op::combine(result, this->values[i]);
+            }
+            return result;
+        }
+        Acc result = this->suffix[l];
+        if (last - first > 1)
+        {
+            result = Op::combine(result, this->blocks.query(first + 1, last - 1));
+        }
+        return Op::combine(result, this->prefix[r]);
+    }
+
+public:
+    BlockSparseTable(const T *data, size_t n, ScanKernel kernel = ScanKernel::Auto)
+        : N(n), values(data, data + n), prefix(n), suffix(_suffixes(data, n)), blocks(_block_totals(suffix), kernel)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            this->prefix[i] = i % BLOCK == 0 ? this->values[i] : Op::combine(this->prefix[i - 1], this->values[i]);
+        }
+    }
+
+    explicit BlockSparseTable(const vector<T> &arr, ScanKernel kernel = ScanKernel::Auto)
+        : BlockSparseTable(arr.data(), arr.size(), kernel)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->N;
+    }
+
+    bool valid_range(long long l, long long r) const
+    {
+        return ::valid_range(l, r, this->N);
+    }
+
+    /**
+     * @brief Combination of arr[l..r], or invalid_query() if the range is out of bounds.
+     */
+    Acc query(long long l, long long r) const
+    {
+        if (!this->valid_range(l, r))
+        {
+            return invalid_query();
+        }
+        return this->_query(l, r);
+    }
+
+    /**
+     * @brief Answers a batch of queries, see SparseTable::range_queries().
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, Acc *results, bool sort_queries = false) const
+    {
+        return answer_range_queries(this->N, queries, count, results, invalid_query(), sort_queries,
+                                    [this](long long l, long long r)
+                                    { return this->_query(l, r); });
+    }
+
+    size_t memory_bytes() const
+    {
+        return (this->values.capacity() + this->prefix.capacity() + this->suffix.capacity()) * sizeof(Acc) +
+               this->blocks.memory_bytes();
+    }
+};
+
+#endif // SPARSE_TABLE_H
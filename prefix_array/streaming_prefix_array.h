@@ -0,0 +1,427 @@
+#ifndef STREAMING_PREFIX_ARRAY_H
+#define STREAMING_PREFIX_ARRAY_H
+
+#include "prefix_array.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Range sum and range xor queries in O(1) over a series that keeps growing.
+ *
+ * Prefix values are stored in fixed chunks of CHUNK positions that are never moved, so
+ * append() is O(1) without reallocation copying; only the small table of chunk pointers is
+ * copied when it doubles. Batches appended through append(data, count) are scanned straight
+ * into the chunks with prefix_scan().
+ *
+ * Thread safety: one writer thread may append while any number of reader threads query.
+ * The writer publishes the element count with a release store after the prefix values are
+ * written, and every query reads it with an acquire load first, so a query sees a complete
+ * prefix of the series. Outgrown chunk tables are kept until destruction, so a reader never
+ * follows a freed pointer.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class AppendablePrefixArray
+{
+public:
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK = size_t(1) << CHUNK_BITS;
+
+private:
+    struct Chunk
+    {
+        Acc sum[CHUNK];
+        Acc xor_value[CHUNK];
+    };
+
+    struct Directory
+    {
+        size_t capacity;
+        unique_ptr<Chunk *[]> chunks;
+    };
+
+    atomic<long long> elements;
+    atomic<Directory *> directory;
+
+    // Writer-side state.
+    vector<unique_ptr<Chunk>> owned_chunks;
+    vector<unique_ptr<Directory>> owned_directories;
+    Acc sum;
+    Acc xor_value;
+    ScanKernel kernel;
+
+    /**
+     * @brief Makes sure the chunk holding position exists; writer only.
+     */
+    Chunk *_chunk_for(long long position)
+    {
+        size_t index = position >> CHUNK_BITS;
+        if (index < this->owned_chunks.size())
+        {
+            return this->owned_chunks[index].get();
+        }
+        Directory *current = this->directory.load(memory_order_relaxed);
+        if (!current || index >= current->capacity)
+        {
+            unique_ptr<Directory> grown(new Directory{current ? 2 * current->capacity : 16, nullptr});
+            grown->chunks.reset(new Chunk *[grown->capacity]());
+            for (size_t i = 0; i < this->owned_chunks.size(); i++)
+            {
+                grown->chunks[i] = this->owned_chunks[i].get();
+            }
+            current = grown.get();
+            this->owned_directories.push_back(move(grown));
+            this->directory.store(current, memory_order_release);
+        }
+        this->owned_chunks.emplace_back(new Chunk);
+        current->chunks[index] = this->owned_chunks.back().get();
+        return this->owned_chunks.back().get();
+    }
+
+    const Chunk &_reader_chunk(long long position) const
+    {
+        return *this->directory.load(memory_order_acquire)->chunks[position >> CHUNK_BITS];
+    }
+
+    Acc _prefix_sum(long long position) const
+    {
+        return this->_reader_chunk(position).sum[position & (CHUNK - 1)];
+    }
+
+    Acc _prefix_xor(long long position) const
+    {
+        return this->_reader_chunk(position).xor_value[position & (CHUNK - 1)];
+    }
+
+    RangeAggregates<Acc> _range(long long l, long long r) const
+    {
+        const Chunk &high = this->_reader_chunk(r + 1), &low = this->_reader_chunk(l);
+        size_t h = (r + 1) & (CHUNK - 1), o = l & (CHUNK - 1);
+        return {SumOp<Acc>::subtract(high.sum[h], low.sum[o]),
+                XorOp<Acc>::subtract(high.xor_value[h], low.xor_value[o])};
+    }
+
+public:
+    /**
+     * @param kernel Scan kernel for batch appends, see prefix_scan().
+     */
+    explicit AppendablePrefixArray(ScanKernel kernel = ScanKernel::Auto)
+        : elements(0), directory(nullptr), sum(SumOp<Acc>::identity()), xor_value(XorOp<Acc>::identity()),
+          kernel(kernel)
+    {
+        Chunk *first = this->_chunk_for(0);
+        first->sum[0] = this->sum;
+        first->xor_value[0] = this->xor_value;
+    }
+
+    AppendablePrefixArray(const AppendablePrefixArray &) = delete;
+    AppendablePrefixArray &operator=(const AppendablePrefixArray &) = delete;
+
+    /**
+     * @brief Appends one sample; writer thread only.
+     */
+    void append(T value)
+    {
+        long long position = this->elements.load(memory_order_relaxed) + 1;
+        Chunk *chunk = this->_chunk_for(position);
+        this->sum = SumOp<Acc>::combine(this->sum, Acc(value));
+        this->xor_value = XorOp<Acc>::combine(this->xor_value, Acc(value));
+        chunk->sum[position & (CHUNK - 1)] = this->sum;
+        chunk->xor_value[position & (CHUNK - 1)] = this->xor_value;
+        this->elements.store(position, memory_order_release);
+    }
+
+    /**
+     * @brief Appends count samples, scanning them chunk by chunk; writer thread only.
+     *
+     * Readers see the new samples one chunk at a time.
+     */
+    void append(const T *data, size_t count)
+    {
+        long long done = this->elements.load(memory_order_relaxed);
+        while (count > 0)
+        {
+            long long position = done + 1;
+            Chunk *chunk = this->_chunk_for(position);
+            size_t offset = position & (CHUNK - 1);
+            size_t step = min(count, CHUNK - offset);
+            this->sum = prefix_scan<T, Acc, SumOp<Acc>>(data, chunk->sum + offset, step, this->sum, this->kernel);
+            this->xor_value = prefix_scan<T, Acc, XorOp<Acc>>(data, chunk->xor_value + offset, step, this->xor_value,
+                                                              this->kernel);
+            done += step;
+            this->elements.store(done, memory_order_release);
+            data += step;
+            count -= step;
+        }
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    /**
+     * @brief Number of samples published so far.
+     */
+    long long size() const
+    {
+        return this->elements.load(memory_order_acquire);
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->size()))
+        {
+            return invalid_query();
+        }
+        return SumOp<Acc>::subtract(this->_prefix_sum(r + 1), this->_prefix_sum(l));
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        if (!valid_range(l, r, this->size()))
+        {
+            return invalid_query();
+        }
+        return XorOp<Acc>::subtract(this->_prefix_xor(r + 1), this->_prefix_xor(l));
+    }
+
+    /**
+     * @brief Sum and xor of the last count samples, or invalid_query() in both fields if
+     *        count is 0 or more than have been appended.
+     */
+    RangeAggregates<Acc> window_query(long long count) const
+    {
+        long long n = this->size();
+        if (!valid_range(n - count, n - 1, n))
+        {
+            return {invalid_query(), invalid_query()};
+        }
+        return this->_range(n - count, n - 1);
+    }
+
+    /**
+     * @brief Answers a batch of queries against the samples published when the call starts,
+     *        see PrefixArray::range_queries().
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, RangeAggregates<Acc> *results,
+                         bool sort_queries = false) const
+    {
+        return answer_range_queries(this->size(), queries, count, results, {invalid_query(), invalid_query()},
+                                    sort_queries, [this](long long l, long long r)
+                                    { return this->_range(l, r); });
+    }
+};
+
+/**
+ * @brief Sliding-window range sum and range xor queries in O(1) and fixed memory.
+ *
+ * Prefix values live in a ring of CAPACITY slots, the next power of two above window, so
+ * the ring always holds the last window samples and usually a few more. Samples keep their
+ * global index (0 for the first sample ever appended); ranges that start before oldest()
+ * have been evicted and get invalid_query().
+ *
+ * Thread safety: one writer thread may append while any number of reader threads query.
+ * The ring slots are relaxed atomics. Before overwriting a slot the writer announces the
+ * position it is about to write, and a reader that finds after its loads that one of its
+ * slots may have been overwritten meanwhile retries, seqlock-style, so a query never mixes
+ * values from different positions. GCC's ThreadSanitizer does not model the standalone
+ * fences this relies on (it says so with -Wtsan); since every shared slot is an atomic it
+ * reports no races here, but it cannot check the retry either. The concurrent streaming
+ * section of prefix_bench does, against closed-form window sums.
+ *
+ * @tparam T Element type.
+ * @tparam Acc Accumulator type.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class SlidingWindowPrefixArray
+{
+private:
+    size_t capacity;
+    size_t mask;
+    unique_ptr<atomic<Acc>[]> sums;
+    unique_ptr<atomic<Acc>[]> xors;
+    atomic<long long> elements;
+    atomic<long long> writing;
+
+    // Writer-side state.
+    Acc sum;
+    Acc xor_value;
+
+    static size_t _ring_size(size_t window)
+    {
+        size_t size = 2;
+        while (size < window + 1)
+        {
+            size *= 2;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Position of the oldest prefix value still in the ring when n samples exist.
+     */
+    long long _oldest_position(long long n) const
+    {
+        return max(0LL, n - (long long)this->capacity + 1);
+    }
+
+    /**
+     * @brief Sum and xor of samples [l, r]; false if the range is out of bounds or evicted.
+     */
+    bool _read(long long l, long long r, RangeAggregates<Acc> &result) const
+    {
+        while (true)
+        {
+            long long n = this->elements.load(memory_order_acquire);
+            if (!valid_range(l, r, n) || l < this->_oldest_position(n))
+            {
+                return false;
+            }
+            Acc high_sum = this->sums[(r + 1) & this->mask].load(memory_order_relaxed);
+            Acc low_sum = this->sums[l & this->mask].load(memory_order_relaxed);
+            Acc high_xor = this->xors[(r + 1) & this->mask].load(memory_order_relaxed);
+            Acc low_xor = this->xors[l & this->mask].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            // Once position writing - capacity is being written, slot l may hold it instead;
+            // the bounds check above then fails on the next round.
+            if (l > this->writing.load(memory_order_relaxed) - (long long)this->capacity)
+            {
+                result = {SumOp<Acc>::subtract(high_sum, low_sum), XorOp<Acc>::subtract(high_xor, low_xor)};
+                return true;
+            }
+        }
+    }
+
+public:
+    /**
+     * @param window Number of most recent samples that must stay queryable.
+     */
+    explicit SlidingWindowPrefixArray(size_t window)
+        : capacity(_ring_size(window)), mask(this->capacity - 1), sums(new atomic<Acc>[this->capacity]),
+          xors(new atomic<Acc>[this->capacity]), elements(0), writing(0), sum(SumOp<Acc>::identity()),
+          xor_value(XorOp<Acc>::identity())
+    {
+        this->sums[0].store(this->sum, memory_order_relaxed);
+        this->xors[0].store(this->xor_value, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Appends one sample, evicting the oldest one once the ring is full; writer
+     *        thread only.
+     */
+    void append(T value)
+    {
+        long long position = this->elements.load(memory_order_relaxed) + 1;
+        this->writing.store(position, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        this->sum = SumOp<Acc>::combine(this->sum, Acc(value));
+        this->xor_value = XorOp<Acc>::combine(this->xor_value, Acc(value));
+        this->sums[position & this->mask].store(this->sum, memory_order_relaxed);
+        this->xors[position & this->mask].store(this->xor_value, memory_order_relaxed);
+        this->elements.store(position, memory_order_release);
+    }
+
+    void append(const T *data, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            this->append(data[i]);
+        }
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    /**
+     * @brief Number of samples appended so far, evicted ones included.
+     */
+    long long size() const
+    {
+        return this->elements.load(memory_order_acquire);
+    }
+
+    /**
+     * @brief Index of the oldest sample that can still start a range.
+     */
+    long long oldest() const
+    {
+        return this->_oldest_position(this->size());
+    }
+
+    /**
+     * @brief Number of ring slots; the structure never uses more memory than this.
+     */
+    size_t ring_size() const
+    {
+        return this->capacity;
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        RangeAggregates<Acc> result;
+        return this->_read(l, r, result) ? result.sum : invalid_query();
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        RangeAggregates<Acc> result;
+        return this->_read(l, r, result) ? result.xor_value : invalid_query();
+    }
+
+    /**
+     * @brief Sum and xor of the last count samples, or invalid_query() in both fields if
+     *        count is 0 or more than the ring holds.
+     */
+    RangeAggregates<Acc> window_query(long long count) const
+    {
+        RangeAggregates<Acc> result;
+        while (true)
+        {
+            long long n = this->size();
+            if (count <= 0 || n - count < this->_oldest_position(n))
+            {
+                return {invalid_query(), invalid_query()};
+            }
+            // Fails only if the writer evicted the start of the window meanwhile.
+            if (this->_read(n - count, n - 1, result))
+            {
+                return result;
+            }
+        }
+    }
+
+    /**
+     * @brief Answers a batch of queries by global sample index, see PrefixArray::range_queries().
+     *
+     * Queries that have been evicted by the time they are answered get invalid_query().
+     */
+    size_t range_queries(const RangeQuery *queries, size_t count, RangeAggregates<Acc> *results,
+                         bool sort_queries = false) const
+    {
+        const RangeAggregates<Acc> invalid = {invalid_query(), invalid_query()};
+        size_t evicted = 0;
+        size_t valid = answer_range_queries(this->size(), queries, count, results, invalid, sort_queries,
+                                            [&](long long l, long long r)
+                                            {
+                                                RangeAggregates<Acc> result;
+                                                if (this->_read(l, r, result))
+                                                {
+                                                    return result;
+                                                }
+                                                evicted++;
+                                                return invalid;
+                                            });
+        return valid - evicted;
+    }
+};
+
+#endif // STREAMING_PREFIX_ARRAY_H
@@ -0,0 +1,76 @@
+#ifndef UPDATABLE_PREFIX_ARRAY_H
+#define UPDATABLE_PREFIX_ARRAY_H
+
+#include "fenwick_tree.h"
+#include "segment_tree.h"
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Updatable counterpart of PrefixArray: the same range_sum_query / range_xor_query
+ *        surface in O(log n), plus point and batch updates in O(log n) instead of an O(n)
+ *        rebuild.
+ *
+ * Sum and xor are invertible and commutative, so both are kept in Fenwick trees. For
+ * operators without an inverse (min, max, ...), use SegmentTree directly.
+ *
+ * @tparam T Element type (integral).
+ * @tparam Acc Accumulator type.
+ */
+template <typename T = int, typename Acc = wide_accumulator_t<T>>
+class UpdatablePrefixArray
+{
+private:
+    FenwickTree<T, Acc, SumOp<Acc>> prefix_sum_tree;
+    FenwickTree<T, Acc, XorOp<Acc>> prefix_xor_tree;
+
+public:
+    explicit UpdatablePrefixArray(const vector<T> &arr) : prefix_sum_tree(arr), prefix_xor_tree(arr)
+    {
+    }
+
+    static Acc invalid_query()
+    {
+        return invalid_query_value<Acc>();
+    }
+
+    long long size() const
+    {
+        return this->prefix_sum_tree.size();
+    }
+
+    Acc range_sum_query(long long l, long long r) const
+    {
+        return this->prefix_sum_tree.query(l, r);
+    }
+
+    Acc range_xor_query(long long l, long long r) const
+    {
+        return this->prefix_xor_tree.query(l, r);
+    }
+
+    /**
+     * @brief Sets arr[i] to value.
+     *
+     * @return bool False if i is out of bounds.
+     */
+    bool update(long long i, const T &value)
+    {
+        return this->prefix_sum_tree.update(i, value) && this->prefix_xor_tree.update(i, value);
+    }
+
+    /**
+     * @brief Applies a batch of (index, value) assignments; later entries win.
+     *
+     * @return size_t Number of in-bounds assignments applied.
+     */
+    size_t update_batch(const vector<pair<long long, T>> &updates)
+    {
+        this->prefix_xor_tree.update_batch(updates);
+        return this->prefix_sum_tree.update_batch(updates);
+    }
+};
+
+#endif // UPDATABLE_PREFIX_ARRAY_H